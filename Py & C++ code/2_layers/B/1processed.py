@@ -7,7 +7,7 @@ def list_files(directory):                              # Function to get a list
     try:
         files = os.listdir(directory)                   # List all files and directories in the given path
         files = [f for f in files if os.path.isfile(os.path.join(directory, f))] # Filter out only files (ignore directories)
-        files = [f[:-4] if f.endswith('.txt') else f for f in files] # Remove the '.txt' extension (last 4 characters) from file names
+        files = [f[:-4] for f in files if f.endswith('.txt')] # Text files only (.bin files are read directly), remove the '.txt' extension
         return files                                    # Return the processed list of file names
     except FileNotFoundError:
         return f"The directory {directory} was not found." # Handle case where the directory does not exist
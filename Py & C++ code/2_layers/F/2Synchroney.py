@@ -20,6 +20,23 @@ def phase_coherence(angles_vec):
     suma = sum([(np.e ** (1j * i)) for i in angles_vec])
     return abs(suma / len(angles_vec))
 
+TRAJECTORY_HEADER = np.dtype([('magic', 'S4'), ('version', '<u4'), ('N', '<u4'), ('nodes', '<u4'),
+                              ('layer', '<u4'), ('format', '<u4'), ('stride', '<u4'), ('unused', '<u4'),
+                              ('first_step', '<u8'), ('frames', '<u8'),
+                              ('dt', '<f8'), ('coupling', '<f8'), ('scale', '<f8')])   # Trajectory_header in Kuramoto.Version5.h
+TRAJECTORY_DTYPE = {1: '<f8', 2: '<f4', 3: '<i2'}                   # data[10]= 1 float64, 2 float32, 3 int16
+def load_trajectory(file_path):
+    '''
+    Read a .bin phase file written by main.cpp: (frames, N) phases in -pi..pi of the recorded steps and nodes
+    '''
+    header = np.fromfile(file_path, dtype=TRAJECTORY_HEADER, count=1)[0]
+    offset = TRAJECTORY_HEADER.itemsize                                 # a node subset lists its N indices first
+    if header['N'] < header['nodes']:
+        offset += 4 * int(header['N'])
+    phases = np.fromfile(file_path, dtype=TRAJECTORY_DTYPE[int(header['format'])], offset=offset)
+    return phases.reshape(-1, int(header['N'])).astype(np.float32) / np.float32(header['scale'])
+binary_path = './Save/Phases(time)VS(Node)/'                       # .bin files need no 1processed.py step
+
 
 
 
@@ -27,9 +44,9 @@ Layer="L1"
 Forward_or_Backward="F"
 
 directory_path= f'./Python/Phases/{Forward_or_Backward}/{Layer}/'
+binary_files = sorted(f[:-4] for f in os.listdir(binary_path) if f.startswith(Layer + '_') and f.endswith('.bin')) if os.path.isdir(binary_path) else []
 
-
-files = list_files(directory_path)                      # Call the function with the specified directory path
+files = binary_files if binary_files else list_files(directory_path) # Call the function with the specified directory path
 
 # sort based on the number after 'k=' and before 'layer1'
 files = sorted(files, key=lambda x: float(re.search(r'k=([0-9.]+)', x).group(1)))
@@ -44,8 +61,11 @@ print('📂Create a folders for Save data. ')
 k=0
 scale_factor = 100  
 for file in files:
-    loaded = np.load(directory_path + file+'.npz')
-    data=loaded['phases'].astype(np.float32) / scale_factor
+    if binary_files:
+        data = load_trajectory(binary_path + file + '.bin')
+    else:
+        loaded = np.load(directory_path + file+'.npz')
+        data=loaded['phases'].astype(np.float32) / scale_factor
     arr_sync_total=np.zeros(data[:,0].shape)
     for i in range(len(data[:,0])):
         arr_sync_total[i]=phase_coherence(data[i,:])
@@ -62,9 +82,9 @@ Layer="L2"
 Forward_or_Backward="F"
 
 directory_path= f'./Python/Phases/{Forward_or_Backward}/{Layer}/'
+binary_files = sorted(f[:-4] for f in os.listdir(binary_path) if f.startswith(Layer + '_') and f.endswith('.bin')) if os.path.isdir(binary_path) else []
 
-
-files = list_files(directory_path)                      # Call the function with the specified directory path
+files = binary_files if binary_files else list_files(directory_path) # Call the function with the specified directory path
 
 # sort based on the number after 'k=' and before 'layer1'
 files = sorted(files, key=lambda x: float(re.search(r'k=([0-9.]+)', x).group(1)))
@@ -79,8 +99,11 @@ print('📂Create a folders for Save data. ')
 k=0
 scale_factor = 100  
 for file in files:
-    loaded = np.load(directory_path + file+'.npz')
-    data=loaded['phases'].astype(np.float32) / scale_factor
+    if binary_files:
+        data = load_trajectory(binary_path + file + '.bin')
+    else:
+        loaded = np.load(directory_path + file+'.npz')
+        data=loaded['phases'].astype(np.float32) / scale_factor
     arr_sync_total=np.zeros(data[:,0].shape)
     for i in range(len(data[:,0])):
         arr_sync_total[i]=phase_coherence(data[i,:])
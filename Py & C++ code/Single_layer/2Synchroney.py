@@ -4,6 +4,8 @@ import os                                               # Importing the os modul
 import re
 
 directory_path= f'./Python/Phases/'
+# Only needed for the r(t) files of 3plot_synchrony_over_time.py: mean, std, sem and CI of r per
+# coupling come from the C++ run (Save/Syncrony_stats(...)/output.txt, read by 4synchrony_stats_plotter.py)
 
 def list_files(directory):                              # Function to get a list of files from the specified directory
     try:
@@ -16,12 +18,12 @@ def list_files(directory):                              # Function to get a list
     except Exception as e:
         return str(e)                                   # Handle any other unexpected exceptions
 
-def phase_coherence(angles_vec):
+def phase_coherence(angles):
     '''
     Compute global order parameter R_t - mean length of resultant vector
+    (of every row at once for a 2D array of phases, time along the rows)
     '''
-    suma = sum([(np.e ** (1j * i)) for i in angles_vec])
-    return abs(suma / len(angles_vec))
+    return np.abs(np.mean(np.exp(1j * np.asarray(angles, dtype=np.float64)), axis=-1))
 
 files = list_files(directory_path)                      # Call the function with the specified directory path
 
@@ -42,9 +44,7 @@ for file in files:
     loaded = np.load(directory_path + file+'.npz')
     data=loaded['phases'].astype(np.float32) / scale_factor
     print(data.shape)
-    arr_sync_total=np.zeros(data[:,0].shape)
-    for i in range(len(data[:,0])):
-        arr_sync_total[i]=phase_coherence(data[i,:])
+    arr_sync_total=phase_coherence(data)
     np.savez_compressed(f'./Python/Synchrony(T_L_M_R)/'+files[k], phases=arr_sync_total)
     print(f"✅{files[k]} -> Saved.")
     k+=1
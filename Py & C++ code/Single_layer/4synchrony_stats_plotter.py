@@ -31,6 +31,7 @@ def stats_summary(data, confidence=0.95):
 
 last_coupling = 4          # Maximum coupling strength value
 directory_output = f'./Python/Synchrony(T_L_M_R)/'
+stats_table = './Save/Syncrony_stats(couplig_group_mean_std_sem_CI)/output.txt'  # written by the C++ run
 
 # ------------------------------ Load and Analyze Data ------------------------------
 
@@ -56,14 +57,25 @@ def list_sorted_files(directory):
         raise e
 
 
-# 🧾 Get the sorted list of files
-files = list_sorted_files(directory_output)
-
-results = []
-for file in files:
-    loaded = np.load(directory_output + file + '.npz')
-    data_sync = loaded['phases']
-    results.append(stats_summary(data_sync))
+if os.path.isfile(stats_table):
+    # The C++ run already kept these statistics of r(t) on the fly (Welford), so the
+    # trajectories are neither loaded nor needed; the rows of group 'all' are the total r
+    table = pd.read_csv(stats_table, sep='\t', dtype={'group': str})
+    table = table[table['group'] == 'all']
+    k_arr = table['coupling'].to_numpy()
+    results = [{'mean': row['mean'], 'std': row['std'], 'sem': row['sem'],
+                'confidence_interval': (row['ci_low'], row['ci_high'])}
+               for _, row in table.iterrows()]
+else:
+    # 🧾 Get the sorted list of files (runs without the table: from 2Synchroney.py)
+    files = list_sorted_files(directory_output)
+
+    results = []
+    for file in files:
+        loaded = np.load(directory_output + file + '.npz')
+        data_sync = loaded['phases']
+        results.append(stats_summary(data_sync))
+    k_arr = np.linspace(0.0, last_coupling, len(results))  # Coupling values (K)
 
 # Extract mean and standard deviation for plotting
 mean_results = [res['mean'] for res in results]
@@ -71,8 +83,6 @@ std_results = [res['std'] for res in results]
 
 # ------------------------------ Plotting ------------------------------
 
-k_arr = np.linspace(0.0, last_coupling, len(results))  # Coupling values (K)
-
 plt.figure(figsize=(16, 4))  # Wide figure for better visibility
 
 # Plot mean with standard deviation as error bars
@@ -27,9 +27,681 @@
 #include <cmath>//For Example pow                                                                                          $$$$
 #include <omp.h>//                                                                                                         $$$$
 #include <stdio.h>//                                                                                                       $$$$
+#include <vector>//Sparse_adjacency                                                                                        $$$$
+#include <algorithm>//min                                                                                                  $$$$
+#include <new>//align_val_t (Aligned_array)                                                                                $$$$
+#include <cstdint>//uint64_t (bit-packed adjacency)                                                                        $$$$
+#include <iomanip>//setprecision (Trajectory_writer text files)                                                            $$$$
+#include <thread>//Async_output writer thread                                                                              $$$$
+#include <atomic>//Async_output ring indices                                                                               $$$$
+#include <functional>//Async_output sink                                                                                   $$$$
+#include <charconv>//from_chars (Number_file)                                                                              $$$$
+#include <cstring>//memcpy, memcmp                                                                                         $$$$
+#include <sys/stat.h>//size and mtime of the inputs (Number_file)                                                          $$$$
+#ifdef __linux__//                                                                                                         $$$$
+#include <sys/mman.h>//madvise (huge pages)                                                                                $$$$
+#include <fcntl.h>//open (Mapped_file)                                                                                     $$$$
+#include <unistd.h>//close (Mapped_file)                                                                                   $$$$
+#endif//                                                                                                                   $$$$
 #define Pi 3.141592653589793238462643383279502884//pi number                                                               $$$$
 using namespace std;//                                                                                                     $$$$
 //$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$$
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                 OpenMP helpers                                 @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+const int Reduction_block = 256;                                                    //@@@ node loops are orphaned omp for:  ---
+struct Reduction_workspace                                                          //@@@ split over the team inside main's ---
+{                                                                                   //@@@ parallel region, serial outside.  ---
+    vector<double> part_x, part_y;                                                  //@@@ Sums over fixed blocks added in   ---
+    double x = 0.0, y = 0.0;                                                        //@@@ block order: bitwise identical    ---
+    explicit Reduction_workspace(int N = 0)                                         //@@@ for any number of threads         ---
+        : part_x((N+Reduction_block-1)/Reduction_block,0.0),                        //@@@                                   ---
+          part_y((N+Reduction_block-1)/Reduction_block,0.0) {}                      //@@@                                   ---
+};                                                                                  //@@@                                   ---
+void reduce_blocks(int Number_of_blocks,Reduction_workspace& red)                   //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    #pragma omp single                                                              //@@@   implicit barrier after single   ---
+    {                                                                               //@@@                                   ---
+        double x = 0.0, y = 0.0;                                                    //@@@                                   ---
+        for (int k = 0; k < Number_of_blocks; k++){                                 //@@@                                   ---
+            x += red.part_x[k];                                                     //@@@                                   ---
+            y += red.part_y[k];                                                     //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        red.x = x;                                                                  //@@@                                   ---
+        red.y = y;                                                                  //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+int number_of_threads(double requested)                                             //@@@     0 = every core OpenMP sees    ---
+{                                                                                   //@@@                                   ---
+#ifdef _OPENMP                                                                      //@@@                                   ---
+    return requested > 0 ? int(requested) : omp_get_max_threads();                  //@@@                                   ---
+#else                                                                               //@@@                                   ---
+    return 1;                                                                       //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                Aligned storage                                 @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+const int Cache_line_bytes = 64;                                                    //@@@ Aligned_array: one 64-byte        ---
+const size_t Huge_page_bytes = size_t(2) << 20;                                     //@@@ aligned, zero-filled block, freed ---
+template <typename T>                                                               //@@@ by the destructor, move-only.     ---
+class Aligned_array                                                                 //@@@ Blocks of 2 MB or more go on a    ---
+{                                                                                   //@@@ huge page and are offered to THP  ---
+public:                                                                             //@@@ (madvise)                         ---
+    Aligned_array() = default;                                                      //@@@                                   ---
+    explicit Aligned_array(size_t n) : n_(n)                                        //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (n == 0) return;                                                         //@@@                                   ---
+        alignment_ = n*sizeof(T) >= Huge_page_bytes ? Huge_page_bytes               //@@@                                   ---
+                                                    : size_t(Cache_line_bytes);     //@@@                                   ---
+        size_t bytes = (n*sizeof(T)+alignment_-1)/alignment_*alignment_;            //@@@                                   ---
+        p_ = static_cast<T*>(::operator new(bytes,align_val_t(alignment_)));        //@@@                                   ---
+#if defined(__linux__) && defined(MADV_HUGEPAGE)                                    //@@@                                   ---
+        if (alignment_ == Huge_page_bytes) madvise(p_,bytes,MADV_HUGEPAGE);         //@@@   a hint, failure is harmless     ---
+#endif                                                                              //@@@                                   ---
+        fill(p_,p_+n,T());                                                          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    ~Aligned_array() { release(); }                                                 //@@@                                   ---
+    Aligned_array(const Aligned_array&) = delete;                                   //@@@                                   ---
+    Aligned_array& operator=(const Aligned_array&) = delete;                        //@@@                                   ---
+    Aligned_array(Aligned_array&& other) noexcept { swap(other); }                  //@@@                                   ---
+    Aligned_array& operator=(Aligned_array&& other) noexcept                        //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (this != &other){ release(); swap(other); }                              //@@@                                   ---
+        return *this;                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    T& operator[](size_t k) { return p_[k]; }                                       //@@@                                   ---
+    const T& operator[](size_t k) const { return p_[k]; }                           //@@@                                   ---
+    T* data() { return p_; }                                                        //@@@                                   ---
+    const T* data() const { return p_; }                                            //@@@                                   ---
+    size_t size() const { return n_; }                                              //@@@                                   ---
+private:                                                                            //@@@                                   ---
+    void release()                                                                  //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (p_) ::operator delete(p_,align_val_t(alignment_));                      //@@@                                   ---
+        p_ = nullptr; n_ = 0;                                                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    void swap(Aligned_array& other)                                                 //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        std::swap(p_,other.p_); std::swap(n_,other.n_);                             //@@@                                   ---
+        std::swap(alignment_,other.alignment_);                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    T* p_ = nullptr;                                                                //@@@                                   ---
+    size_t n_ = 0;                                                                  //@@@                                   ---
+    size_t alignment_ = Cache_line_bytes;                                           //@@@                                   ---
+};                                                                                  //@@@                                   ---
+template <typename T>                                                               //@@@ Matrix: rows*cols in one Aligned_ ---
+class Matrix                                                                        //@@@ array, row i at i*stride, stride  ---
+{                                                                                   //@@@ rounded up to whole 64-byte       ---
+public:                                                                             //@@@ lines: every row starts aligned   ---
+    Matrix() = default;                                                             //@@@ and the rows follow each other    ---
+    Matrix(int rows,int cols)                                                       //@@@ for the prefetcher                ---
+        : rows_(rows), cols_(cols), stride_(padded_stride(cols)),                   //@@@                                   ---
+          elements_(size_t(rows)*stride_) {}                                        //@@@                                   ---
+    static size_t padded_stride(int cols)                                           //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        return (size_t(cols)*sizeof(T)+Cache_line_bytes-1)/Cache_line_bytes         //@@@                                   ---
+               *Cache_line_bytes/sizeof(T);                                         //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    T* operator[](int i) { return elements_.data()+size_t(i)*stride_; }             //@@@                                   ---
+    const T* operator[](int i) const                                                //@@@                                   ---
+    { return elements_.data()+size_t(i)*stride_; }                                  //@@@                                   ---
+    int rows() const { return rows_; }                                              //@@@                                   ---
+    int cols() const { return cols_; }                                              //@@@                                   ---
+    size_t stride() const { return stride_; }                                       //@@@                                   ---
+private:                                                                            //@@@                                   ---
+    int rows_ = 0, cols_ = 0;                                                       //@@@                                   ---
+    size_t stride_ = 0;                                                             //@@@                                   ---
+    Aligned_array<T> elements_;                                                     //@@@                                   ---
+};                                                                                  //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                  SIMD kernels                                  @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))                 //@@@ hot loops: N sin/cos per step and ---
+#define KURAMOTO_SIMD_X86 1                                                         //@@@ row sums sum_j w_j x_j. libm sin  ---
+#include <immintrin.h>                                                              //@@@ blocks vectorising, so:           ---
+#define KURAMOTO_TARGET_AVX2 __attribute__((target("avx2,fma,popcnt,bmi")))         //@@@ polynomial sincos + AVX2/AVX-512  ---
+#define KURAMOTO_TARGET_AVX512 __attribute__((target("avx512f,popcnt,bmi")))        //@@@ paths, picked at run time from    ---
+#endif                                                                              //@@@ CPUID                             ---
+enum Simd_level { Simd_scalar = 0, Simd_avx2 = 1, Simd_avx512 = 2 };                //@@@                                   ---
+const char* const Simd_level_name[3] = {"scalar","avx2","avx512"};                  //@@@                                   ---
+Simd_level simd_detect()                                                            //@@@                                   ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    __builtin_cpu_init();                                                           //@@@                                   ---
+    if (__builtin_cpu_supports("avx512f")) return Simd_avx512;                      //@@@                                   ---
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))            //@@@                                   ---
+        return Simd_avx2;                                                           //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    return Simd_scalar;                                                             //@@@    no x86: portable scalar code   ---
+}                                                                                   //@@@                                   ---
+Simd_level& simd_level()                                                            //@@@  detected on first use, assign    ---
+{                                                                                   //@@@  to force a lower path            ---
+    static Simd_level level = simd_detect();                                        //@@@                                   ---
+    return level;                                                                   //@@@                                   ---
+}                                                                                   //@@@                                   ---
+const double Simd_trig_limit = 1.0e6;                                               //@@@ x=q*pi/2+r |r|<=pi/4 Cody-Waite,  ---
+const double Simd_two_over_pi = 6.36619772367581382433e-01;                         //@@@ fdlibm polynomials for sin r and  ---
+const double Simd_round_magic = 6755399441055744.0;                                 //@@@ cos r, quadrant q mod 4 swaps/    ---
+const double Simd_pio2_1 = 1.57079632673412561417e+00;                              //@@@ negates. Max error 2 ulp vs libm  ---
+const double Simd_pio2_2 = 6.07710050630396597660e-11;                              //@@@ for |x|<=Simd_trig_limit (simd_   ---
+const double Simd_pio2_3 = 2.02226624871116645580e-21;                              //@@@ diagnostics), libm beyond that    ---
+const double Simd_S1 = -1.66666666666666324348e-01;                                 //@@@                                   ---
+const double Simd_S2 =  8.33333333332248946124e-03;                                 //@@@ magic=1.5*2^52: y+magic rounds y  ---
+const double Simd_S3 = -1.98412698298579493134e-04;                                 //@@@ to nearest even, low mantissa     ---
+const double Simd_S4 =  2.75573137070700676789e-06;                                 //@@@ bits hold q mod 4                 ---
+const double Simd_S5 = -2.50507602534068634195e-08;                                 //@@@                                   ---
+const double Simd_S6 =  1.58969099521155010221e-10;                                 //@@@ pio2_k: 33 bits each, q<2^20 so   ---
+const double Simd_C1 =  4.16666666666666019037e-02;                                 //@@@ q*pio2_k is exact                 ---
+const double Simd_C2 = -1.38888888888741095749e-03;                                 //@@@                                   ---
+const double Simd_C3 =  2.48015872894767294178e-05;                                 //@@@                                   ---
+const double Simd_C4 = -2.75573143513906633035e-07;                                 //@@@                                   ---
+const double Simd_C5 =  2.08757232129817482790e-09;                                 //@@@                                   ---
+const double Simd_C6 = -1.13596475577881948265e-11;                                 //@@@                                   ---
+inline void sincos_scalar(double x,double& s,double& c)                             //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    if (!(fabs(x) <= Simd_trig_limit)){                                             //@@@        also catches NaN           ---
+        s = sin(x);                                                                 //@@@                                   ---
+        c = cos(x);                                                                 //@@@                                   ---
+        return;                                                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const double q = nearbyint(x*Simd_two_over_pi);                                 //@@@                                   ---
+    const double r = ((x - q*Simd_pio2_1) - q*Simd_pio2_2) - q*Simd_pio2_3;         //@@@                                   ---
+    const double z = r*r;                                                           //@@@                                   ---
+    const double ps = Simd_S2+z*(Simd_S3+z*(Simd_S4+z*(Simd_S5+z*Simd_S6)));        //@@@                                   ---
+    const double pc = Simd_C1+z*(Simd_C2+z*(Simd_C3+z*(Simd_C4+z*(Simd_C5           //@@@                                   ---
+                      +z*Simd_C6))));                                               //@@@                                   ---
+    const double sr = r + r*z*(Simd_S1+z*ps);                                       //@@@                                   ---
+    const double hz = 0.5*z, w = 1.0-hz;                                            //@@@                                   ---
+    const double cr = w + (((1.0-w)-hz) + z*z*pc);                                  //@@@                                   ---
+    switch (int(q) & 3){                                                            //@@@                                   ---
+        case 0: s = sr; c = cr; break;                                              //@@@                                   ---
+        case 1: s = cr; c = -sr; break;                                             //@@@                                   ---
+        case 2: s = -sr; c = -cr; break;                                            //@@@                                   ---
+        default: s = -cr; c = sr; break;                                            //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void sincos_array_scalar(int n,const double* x,double* s,double* c)                 //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    for (int j = 0; j < n; j++) sincos_scalar(x[j],s[j],c[j]);                      //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void sum_sincos_scalar(int n,const double* x,double& S,double& C)                   //@@@   S=sum sin x_j  C=sum cos x_j    ---
+{                                                                                   //@@@                                   ---
+    double rs = 0.0, rc = 0.0;                                                      //@@@                                   ---
+    for (int j = 0; j < n; j++){                                                    //@@@                                   ---
+        double s, c;                                                                //@@@                                   ---
+        sincos_scalar(x[j],s,c);                                                    //@@@                                   ---
+        rs += s;                                                                    //@@@                                   ---
+        rc += c;                                                                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    S = rs;                                                                         //@@@                                   ---
+    C = rc;                                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void sum_pair_scalar(int n,const double* a,const double* b,double& A,double& B)     //@@@     A=sum a_j  B=sum b_j          ---
+{                                                                                   //@@@                                   ---
+    double ra = 0.0, rb = 0.0;                                                      //@@@                                   ---
+    for (int j = 0; j < n; j++){                                                    //@@@                                   ---
+        ra += a[j];                                                                 //@@@                                   ---
+        rb += b[j];                                                                 //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    A = ra;                                                                         //@@@                                   ---
+    B = rb;                                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void dot_pair_scalar(int n,const double* wc,const double* wsn,const double* s,      //@@@  P=sum wc_j s_j + wsn_j c_j       ---
+                     const double* c,double& P,double& Q)                           //@@@  Q=sum wc_j c_j - wsn_j s_j       ---
+{                                                                                   //@@@                                   ---
+    double rp = 0.0, rq = 0.0;                                                      //@@@                                   ---
+    for (int j = 0; j < n; j++){                                                    //@@@                                   ---
+        rp += wc[j]*s[j] + wsn[j]*c[j];                                             //@@@                                   ---
+        rq += wc[j]*c[j] - wsn[j]*s[j];                                             //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    P = rp;                                                                         //@@@                                   ---
+    Q = rq;                                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+inline int lowest_set_bit(uint64_t w)                                               //@@@        index of it (tzcnt)        ---
+{                                                                                   //@@@                                   ---
+#if defined(__GNUC__)                                                               //@@@                                   ---
+    return __builtin_ctzll(w);                                                      //@@@                                   ---
+#else                                                                               //@@@                                   ---
+    int k = 0;                                                                      //@@@                                   ---
+    while (!(w & 1)){ w >>= 1; k++; }                                               //@@@                                   ---
+    return k;                                                                       //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void bit_pair_scalar(int words,const uint64_t* bits,const double* s,                //@@@  P=sum s_j, Q=sum c_j over the    ---
+                     const double* c,double& P,double& Q)                           //@@@  set bits j of a bit-packed row   ---
+{                                                                                   //@@@                                   ---
+    double rp = 0.0, rq = 0.0;                                                      //@@@                                   ---
+    for (int k = 0; k < words; k++){                                                //@@@                                   ---
+        for (uint64_t w = bits[k]; w; w &= w-1){                                    //@@@   clear the lowest set bit        ---
+            const int j = 64*k + lowest_set_bit(w);                                 //@@@                                   ---
+            rp += s[j];                                                             //@@@                                   ---
+            rq += c[j];                                                             //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    P = rp;                                                                         //@@@                                   ---
+    Q = rq;                                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+KURAMOTO_TARGET_AVX2 inline void sincos_pd(__m256d x,__m256d& s,__m256d& c)         //@@@        4 lanes, same steps        ---
+{                                                                                   //@@@        as sincos_scalar           ---
+    const __m256d magic = _mm256_set1_pd(Simd_round_magic);                         //@@@                                   ---
+    const __m256d t = _mm256_add_pd(                                                //@@@                                   ---
+                      _mm256_mul_pd(x,_mm256_set1_pd(Simd_two_over_pi)),magic);     //@@@                                   ---
+    const __m256d q = _mm256_sub_pd(t,magic);                                       //@@@                                   ---
+    __m256d r = _mm256_fnmadd_pd(q,_mm256_set1_pd(Simd_pio2_1),x);                  //@@@                                   ---
+    r = _mm256_fnmadd_pd(q,_mm256_set1_pd(Simd_pio2_2),r);                          //@@@                                   ---
+    r = _mm256_fnmadd_pd(q,_mm256_set1_pd(Simd_pio2_3),r);                          //@@@                                   ---
+    const __m256d z = _mm256_mul_pd(r,r);                                           //@@@                                   ---
+    __m256d ps = _mm256_set1_pd(Simd_S6);                                           //@@@                                   ---
+    ps = _mm256_fmadd_pd(z,ps,_mm256_set1_pd(Simd_S5));                             //@@@                                   ---
+    ps = _mm256_fmadd_pd(z,ps,_mm256_set1_pd(Simd_S4));                             //@@@                                   ---
+    ps = _mm256_fmadd_pd(z,ps,_mm256_set1_pd(Simd_S3));                             //@@@                                   ---
+    ps = _mm256_fmadd_pd(z,ps,_mm256_set1_pd(Simd_S2));                             //@@@                                   ---
+    ps = _mm256_fmadd_pd(z,ps,_mm256_set1_pd(Simd_S1));                             //@@@                                   ---
+    const __m256d sr = _mm256_fmadd_pd(_mm256_mul_pd(r,z),ps,r);                    //@@@                                   ---
+    __m256d pc = _mm256_set1_pd(Simd_C6);                                           //@@@                                   ---
+    pc = _mm256_fmadd_pd(z,pc,_mm256_set1_pd(Simd_C5));                             //@@@                                   ---
+    pc = _mm256_fmadd_pd(z,pc,_mm256_set1_pd(Simd_C4));                             //@@@                                   ---
+    pc = _mm256_fmadd_pd(z,pc,_mm256_set1_pd(Simd_C3));                             //@@@                                   ---
+    pc = _mm256_fmadd_pd(z,pc,_mm256_set1_pd(Simd_C2));                             //@@@                                   ---
+    pc = _mm256_fmadd_pd(z,pc,_mm256_set1_pd(Simd_C1));                             //@@@                                   ---
+    const __m256d one = _mm256_set1_pd(1.0);                                        //@@@                                   ---
+    const __m256d hz = _mm256_mul_pd(_mm256_set1_pd(0.5),z);                        //@@@                                   ---
+    const __m256d w = _mm256_sub_pd(one,hz);                                        //@@@                                   ---
+    const __m256d lo = _mm256_sub_pd(_mm256_sub_pd(one,w),hz);                      //@@@                                   ---
+    const __m256d cr = _mm256_add_pd(w,                                             //@@@                                   ---
+                       _mm256_fmadd_pd(_mm256_mul_pd(z,z),pc,lo));                  //@@@                                   ---
+    const __m256i n = _mm256_castpd_si256(t);                                       //@@@                                   ---
+    const __m256i one_i = _mm256_set1_epi64x(1), two_i = _mm256_set1_epi64x(2);     //@@@                                   ---
+    const __m256d swap = _mm256_castsi256_pd(                                       //@@@     odd quadrant: swap sin/cos    ---
+                         _mm256_cmpeq_epi64(_mm256_and_si256(n,one_i),one_i));      //@@@                                   ---
+    const __m256i sign_s = _mm256_slli_epi64(_mm256_and_si256(n,two_i),62);         //@@@                                   ---
+    const __m256i sign_c = _mm256_slli_epi64(                                       //@@@                                   ---
+                           _mm256_and_si256(_mm256_add_epi64(n,one_i),two_i),62);   //@@@                                   ---
+    s = _mm256_xor_pd(_mm256_blendv_pd(sr,cr,swap),_mm256_castsi256_pd(sign_s));    //@@@                                   ---
+    c = _mm256_xor_pd(_mm256_blendv_pd(cr,sr,swap),_mm256_castsi256_pd(sign_c));    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 inline void sincos_pd_checked(__m256d x,__m256d& s,            //@@@  libm for lanes |x|>Simd_trig_    ---
+                                                   __m256d& c)                      //@@@  limit (or NaN), the others keep  ---
+{                                                                                   //@@@  the polynomial                   ---
+    sincos_pd(x,s,c);                                                               //@@@                                   ---
+    const __m256d abs_x = _mm256_andnot_pd(_mm256_set1_pd(-0.0),x);                 //@@@                                   ---
+    const int in_range = _mm256_movemask_pd(                                        //@@@                                   ---
+                _mm256_cmp_pd(abs_x,_mm256_set1_pd(Simd_trig_limit),_CMP_LE_OQ));   //@@@                                   ---
+    if (in_range == 0xF) return;                                                    //@@@                                   ---
+    alignas(32) double xs[4], ss[4], cs[4];                                         //@@@                                   ---
+    _mm256_store_pd(xs,x);                                                          //@@@                                   ---
+    _mm256_store_pd(ss,s);                                                          //@@@                                   ---
+    _mm256_store_pd(cs,c);                                                          //@@@                                   ---
+    for (int k = 0; k < 4; k++){                                                    //@@@                                   ---
+        if (in_range >> k & 1) continue;                                            //@@@                                   ---
+        ss[k] = sin(xs[k]);                                                         //@@@                                   ---
+        cs[k] = cos(xs[k]);                                                         //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    s = _mm256_load_pd(ss);                                                         //@@@                                   ---
+    c = _mm256_load_pd(cs);                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 void sincos_array_avx2(int n,const double* x,double* s,        //@@@                                   ---
+                                            double* c)                              //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    __m256d vs, vc;                                                                 //@@@                                   ---
+    for (; j + 4 <= n; j += 4){                                                     //@@@                                   ---
+        sincos_pd_checked(_mm256_loadu_pd(x+j),vs,vc);                              //@@@                                   ---
+        _mm256_storeu_pd(s+j,vs);                                                   //@@@                                   ---
+        _mm256_storeu_pd(c+j,vc);                                                   //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (j < n){                                                                     //@@@   tail through a padded vector:   ---
+        alignas(32) double xs[4] = {0.0,0.0,0.0,0.0}, ss[4], cs[4];                 //@@@   a value never depends on where  ---
+        for (int k = 0; j + k < n; k++) xs[k] = x[j+k];                             //@@@   a thread's chunk starts         ---
+        sincos_pd_checked(_mm256_load_pd(xs),vs,vc);                                //@@@                                   ---
+        _mm256_store_pd(ss,vs);                                                     //@@@                                   ---
+        _mm256_store_pd(cs,vc);                                                     //@@@                                   ---
+        for (int k = 0; j + k < n; k++){                                            //@@@                                   ---
+            s[j+k] = ss[k];                                                         //@@@                                   ---
+            c[j+k] = cs[k];                                                         //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 inline double hsum(__m256d v)                                  //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(v),                         //@@@                                   ---
+                                 _mm256_extractf128_pd(v,1));                       //@@@                                   ---
+    return _mm_cvtsd_f64(_mm_add_sd(h,_mm_unpackhi_pd(h,h)));                       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 void sum_sincos_avx2(int n,const double* x,double& S,          //@@@                                   ---
+                                          double& C)                                //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m256d as = _mm256_setzero_pd(), ac = _mm256_setzero_pd(), vs, vc;             //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 4 <= n; j += 4){                                                     //@@@                                   ---
+        sincos_pd_checked(_mm256_loadu_pd(x+j),vs,vc);                              //@@@                                   ---
+        as = _mm256_add_pd(as,vs);                                                  //@@@                                   ---
+        ac = _mm256_add_pd(ac,vc);                                                  //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double rs, rc;                                                                  //@@@                                   ---
+    sum_sincos_scalar(n-j,x+j,rs,rc);                                               //@@@                                   ---
+    S = hsum(as) + rs;                                                              //@@@                                   ---
+    C = hsum(ac) + rc;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 void sum_pair_avx2(int n,const double* a,const double* b,      //@@@                                   ---
+                                        double& A,double& B)                        //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m256d aa = _mm256_setzero_pd(), ab = _mm256_setzero_pd();                     //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 4 <= n; j += 4){                                                     //@@@                                   ---
+        aa = _mm256_add_pd(aa,_mm256_loadu_pd(a+j));                                //@@@                                   ---
+        ab = _mm256_add_pd(ab,_mm256_loadu_pd(b+j));                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double ra, rb;                                                                  //@@@                                   ---
+    sum_pair_scalar(n-j,a+j,b+j,ra,rb);                                             //@@@                                   ---
+    A = hsum(aa) + ra;                                                              //@@@                                   ---
+    B = hsum(ab) + rb;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX2 void dot_pair_avx2(int n,const double* wc,const double* wsn,   //@@@                                   ---
+                                        const double* s,const double* c,            //@@@                                   ---
+                                        double& P,double& Q)                        //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m256d ap = _mm256_setzero_pd(), aq = _mm256_setzero_pd();                     //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 4 <= n; j += 4){                                                     //@@@                                   ---
+        const __m256d vc = _mm256_loadu_pd(wc+j), vs = _mm256_loadu_pd(wsn+j);      //@@@                                   ---
+        const __m256d xs = _mm256_loadu_pd(s+j), xc = _mm256_loadu_pd(c+j);         //@@@                                   ---
+        ap = _mm256_fmadd_pd(vs,xc,_mm256_fmadd_pd(vc,xs,ap));                      //@@@                                   ---
+        aq = _mm256_fnmadd_pd(vs,xs,_mm256_fmadd_pd(vc,xc,aq));                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double rp, rq;                                                                  //@@@                                   ---
+    dot_pair_scalar(n-j,wc+j,wsn+j,s+j,c+j,rp,rq);                                  //@@@                                   ---
+    P = hsum(ap) + rp;                                                              //@@@                                   ---
+    Q = hsum(aq) + rq;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+const int Bit_walk_limit = 12;                                                      //@@@ words with fewer set bits are     ---
+alignas(32) const int64_t Nibble_lane_mask[16][4] = {                               //@@@ walked bit by bit, the others go  ---
+    {0,0,0,0},{-1,0,0,0},{0,-1,0,0},{-1,-1,0,0},                                    //@@@ through masked lanes: a 4-bit     ---
+    {0,0,-1,0},{-1,0,-1,0},{0,-1,-1,0},{-1,-1,-1,0},                                //@@@ group (AVX2) or a byte (AVX-512)  ---
+    {0,0,0,-1},{-1,0,0,-1},{0,-1,0,-1},{-1,-1,0,-1},                                //@@@ is the lane mask of one load      ---
+    {0,0,-1,-1},{-1,0,-1,-1},{0,-1,-1,-1},{-1,-1,-1,-1}};                           //@@@                                   ---
+KURAMOTO_TARGET_AVX2 void bit_pair_avx2(int words,const uint64_t* bits,             //@@@                                   ---
+                                        const double* s,const double* c,            //@@@                                   ---
+                                        double& P,double& Q)                        //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m256d ap = _mm256_setzero_pd(), aq = _mm256_setzero_pd();                     //@@@                                   ---
+    double rp = 0.0, rq = 0.0;                                                      //@@@                                   ---
+    for (int k = 0; k < words; k++){                                                //@@@                                   ---
+        const uint64_t w = bits[k];                                                 //@@@                                   ---
+        if (__builtin_popcountll(w) < Bit_walk_limit){                              //@@@                                   ---
+            for (uint64_t v = w; v; v &= v-1){                                      //@@@                                   ---
+                const int j = 64*k + lowest_set_bit(v);                             //@@@                                   ---
+                rp += s[j];                                                         //@@@                                   ---
+                rq += c[j];                                                         //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (k == words-1){                                                          //@@@ may end inside the vectors:       ---
+            for (int g = 0; g < 64; g += 4){                                        //@@@ masked loads do not touch lanes   ---
+                const __m256i mask = _mm256_load_si256(                             //@@@ past N                            ---
+                    (const __m256i*)Nibble_lane_mask[(w >> g) & 15]);               //@@@                                   ---
+                ap = _mm256_add_pd(ap,_mm256_maskload_pd(s+64*k+g,mask));           //@@@                                   ---
+                aq = _mm256_add_pd(aq,_mm256_maskload_pd(c+64*k+g,mask));           //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        for (int g = 0; g < 64; g += 4){                                            //@@@                                   ---
+            const __m256d mask = _mm256_load_pd(                                    //@@@                                   ---
+                (const double*)Nibble_lane_mask[(w >> g) & 15]);                    //@@@                                   ---
+            ap = _mm256_add_pd(ap,_mm256_and_pd(_mm256_loadu_pd(s+64*k+g),mask));   //@@@                                   ---
+            aq = _mm256_add_pd(aq,_mm256_and_pd(_mm256_loadu_pd(c+64*k+g),mask));   //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    P = hsum(ap) + rp;                                                              //@@@                                   ---
+    Q = hsum(aq) + rq;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 inline double hsum(__m512d v)                                //@@@     8 lanes, as _mm512_reduce_add ---
+{                                                                                   //@@@     maskz forms: GCC reads the    ---
+    const __m256d hi = _mm512_maskz_extractf64x4_pd(0xFF,v,1);                      //@@@     undefined pass-through of the ---
+    const __m256d lo = _mm512_maskz_extractf64x4_pd(0xFF,v,0);                      //@@@     plain ones as uninitialised   ---
+    return hsum(_mm256_add_pd(hi,lo));                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 inline void sincos_pd(__m512d x,__m512d& s,__m512d& c)       //@@@     8 lanes, same steps           ---
+{                                                                                   //@@@                                   ---
+    const __m512d magic = _mm512_set1_pd(Simd_round_magic);                         //@@@                                   ---
+    const __m512d t = _mm512_add_pd(                                                //@@@                                   ---
+                      _mm512_mul_pd(x,_mm512_set1_pd(Simd_two_over_pi)),magic);     //@@@                                   ---
+    const __m512d q = _mm512_sub_pd(t,magic);                                       //@@@                                   ---
+    __m512d r = _mm512_fnmadd_pd(q,_mm512_set1_pd(Simd_pio2_1),x);                  //@@@                                   ---
+    r = _mm512_fnmadd_pd(q,_mm512_set1_pd(Simd_pio2_2),r);                          //@@@                                   ---
+    r = _mm512_fnmadd_pd(q,_mm512_set1_pd(Simd_pio2_3),r);                          //@@@                                   ---
+    const __m512d z = _mm512_mul_pd(r,r);                                           //@@@                                   ---
+    __m512d ps = _mm512_set1_pd(Simd_S6);                                           //@@@                                   ---
+    ps = _mm512_fmadd_pd(z,ps,_mm512_set1_pd(Simd_S5));                             //@@@                                   ---
+    ps = _mm512_fmadd_pd(z,ps,_mm512_set1_pd(Simd_S4));                             //@@@                                   ---
+    ps = _mm512_fmadd_pd(z,ps,_mm512_set1_pd(Simd_S3));                             //@@@                                   ---
+    ps = _mm512_fmadd_pd(z,ps,_mm512_set1_pd(Simd_S2));                             //@@@                                   ---
+    ps = _mm512_fmadd_pd(z,ps,_mm512_set1_pd(Simd_S1));                             //@@@                                   ---
+    const __m512d sr = _mm512_fmadd_pd(_mm512_mul_pd(r,z),ps,r);                    //@@@                                   ---
+    __m512d pc = _mm512_set1_pd(Simd_C6);                                           //@@@                                   ---
+    pc = _mm512_fmadd_pd(z,pc,_mm512_set1_pd(Simd_C5));                             //@@@                                   ---
+    pc = _mm512_fmadd_pd(z,pc,_mm512_set1_pd(Simd_C4));                             //@@@                                   ---
+    pc = _mm512_fmadd_pd(z,pc,_mm512_set1_pd(Simd_C3));                             //@@@                                   ---
+    pc = _mm512_fmadd_pd(z,pc,_mm512_set1_pd(Simd_C2));                             //@@@                                   ---
+    pc = _mm512_fmadd_pd(z,pc,_mm512_set1_pd(Simd_C1));                             //@@@                                   ---
+    const __m512d one = _mm512_set1_pd(1.0);                                        //@@@                                   ---
+    const __m512d hz = _mm512_mul_pd(_mm512_set1_pd(0.5),z);                        //@@@                                   ---
+    const __m512d w = _mm512_sub_pd(one,hz);                                        //@@@                                   ---
+    const __m512d lo = _mm512_sub_pd(_mm512_sub_pd(one,w),hz);                      //@@@                                   ---
+    const __m512d cr = _mm512_add_pd(w,                                             //@@@                                   ---
+                       _mm512_fmadd_pd(_mm512_mul_pd(z,z),pc,lo));                  //@@@                                   ---
+    const __m512i n = _mm512_castpd_si512(t);                                       //@@@                                   ---
+    const __m512i one_i = _mm512_set1_epi64(1), two_i = _mm512_set1_epi64(2);       //@@@                                   ---
+    const __mmask8 swap = _mm512_test_epi64_mask(n,one_i);                          //@@@                                   ---
+    const __m512i sign_s = _mm512_maskz_slli_epi64(0xFF,                            //@@@                                   ---
+                           _mm512_and_si512(n,two_i),62);                           //@@@                                   ---
+    const __m512i sign_c = _mm512_maskz_slli_epi64(0xFF,                            //@@@                                   ---
+                           _mm512_and_si512(_mm512_add_epi64(n,one_i),two_i),62);   //@@@                                   ---
+    s = _mm512_castsi512_pd(_mm512_xor_si512(sign_s,                                //@@@                                   ---
+            _mm512_castpd_si512(_mm512_mask_blend_pd(swap,sr,cr))));                //@@@                                   ---
+    c = _mm512_castsi512_pd(_mm512_xor_si512(sign_c,                                //@@@                                   ---
+            _mm512_castpd_si512(_mm512_mask_blend_pd(swap,cr,sr))));                //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 inline void sincos_pd_checked(__m512d x,__m512d& s,          //@@@                                   ---
+                                                     __m512d& c)                    //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    sincos_pd(x,s,c);                                                               //@@@                                   ---
+    const __mmask8 in_range = _mm512_cmp_pd_mask(_mm512_abs_pd(x),                  //@@@                                   ---
+                              _mm512_set1_pd(Simd_trig_limit),_CMP_LE_OQ);          //@@@                                   ---
+    if (in_range == 0xFF) return;                                                   //@@@                                   ---
+    alignas(64) double xs[8], ss[8], cs[8];                                         //@@@                                   ---
+    _mm512_store_pd(xs,x);                                                          //@@@                                   ---
+    _mm512_store_pd(ss,s);                                                          //@@@                                   ---
+    _mm512_store_pd(cs,c);                                                          //@@@                                   ---
+    for (int k = 0; k < 8; k++){                                                    //@@@                                   ---
+        if (in_range >> k & 1) continue;                                            //@@@                                   ---
+        ss[k] = sin(xs[k]);                                                         //@@@                                   ---
+        cs[k] = cos(xs[k]);                                                         //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    s = _mm512_load_pd(ss);                                                         //@@@                                   ---
+    c = _mm512_load_pd(cs);                                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 void sincos_array_avx512(int n,const double* x,double* s,    //@@@                                   ---
+                                                double* c)                          //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    __m512d vs, vc;                                                                 //@@@                                   ---
+    for (; j + 8 <= n; j += 8){                                                     //@@@                                   ---
+        sincos_pd_checked(_mm512_loadu_pd(x+j),vs,vc);                              //@@@                                   ---
+        _mm512_storeu_pd(s+j,vs);                                                   //@@@                                   ---
+        _mm512_storeu_pd(c+j,vc);                                                   //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (j < n){                                                                     //@@@        masked tail                ---
+        const __mmask8 tail = __mmask8((1u << (n-j)) - 1u);                         //@@@                                   ---
+        sincos_pd_checked(_mm512_maskz_loadu_pd(tail,x+j),vs,vc);                   //@@@                                   ---
+        _mm512_mask_storeu_pd(s+j,tail,vs);                                         //@@@                                   ---
+        _mm512_mask_storeu_pd(c+j,tail,vc);                                         //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 void sum_sincos_avx512(int n,const double* x,double& S,      //@@@                                   ---
+                                              double& C)                            //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m512d as = _mm512_setzero_pd(), ac = _mm512_setzero_pd(), vs, vc;             //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 8 <= n; j += 8){                                                     //@@@                                   ---
+        sincos_pd_checked(_mm512_loadu_pd(x+j),vs,vc);                              //@@@                                   ---
+        as = _mm512_add_pd(as,vs);                                                  //@@@                                   ---
+        ac = _mm512_add_pd(ac,vc);                                                  //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double rs, rc;                                                                  //@@@                                   ---
+    sum_sincos_scalar(n-j,x+j,rs,rc);                                               //@@@                                   ---
+    S = hsum(as) + rs;                                                              //@@@                                   ---
+    C = hsum(ac) + rc;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 void sum_pair_avx512(int n,const double* a,                  //@@@                                   ---
+                                            const double* b,double& A,double& B)    //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m512d aa = _mm512_setzero_pd(), ab = _mm512_setzero_pd();                     //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 8 <= n; j += 8){                                                     //@@@                                   ---
+        aa = _mm512_add_pd(aa,_mm512_loadu_pd(a+j));                                //@@@                                   ---
+        ab = _mm512_add_pd(ab,_mm512_loadu_pd(b+j));                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double ra, rb;                                                                  //@@@                                   ---
+    sum_pair_scalar(n-j,a+j,b+j,ra,rb);                                             //@@@                                   ---
+    A = hsum(aa) + ra;                                                              //@@@                                   ---
+    B = hsum(ab) + rb;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 void dot_pair_avx512(int n,const double* wc,                 //@@@                                   ---
+                                            const double* wsn,const double* s,      //@@@                                   ---
+                                            const double* c,double& P,double& Q)    //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m512d ap = _mm512_setzero_pd(), aq = _mm512_setzero_pd();                     //@@@                                   ---
+    int j = 0;                                                                      //@@@                                   ---
+    for (; j + 8 <= n; j += 8){                                                     //@@@                                   ---
+        const __m512d vc = _mm512_loadu_pd(wc+j), vs = _mm512_loadu_pd(wsn+j);      //@@@                                   ---
+        const __m512d xs = _mm512_loadu_pd(s+j), xc = _mm512_loadu_pd(c+j);         //@@@                                   ---
+        ap = _mm512_fmadd_pd(vs,xc,_mm512_fmadd_pd(vc,xs,ap));                      //@@@                                   ---
+        aq = _mm512_fnmadd_pd(vs,xs,_mm512_fmadd_pd(vc,xc,aq));                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double rp, rq;                                                                  //@@@                                   ---
+    dot_pair_scalar(n-j,wc+j,wsn+j,s+j,c+j,rp,rq);                                  //@@@                                   ---
+    P = hsum(ap) + rp;                                                              //@@@                                   ---
+    Q = hsum(aq) + rq;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+KURAMOTO_TARGET_AVX512 void bit_pair_avx512(int words,const uint64_t* bits,         //@@@                                   ---
+                                            const double* s,const double* c,        //@@@                                   ---
+                                            double& P,double& Q)                    //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    __m512d ap = _mm512_setzero_pd(), aq = _mm512_setzero_pd();                     //@@@                                   ---
+    double rp = 0.0, rq = 0.0;                                                      //@@@                                   ---
+    for (int k = 0; k < words; k++){                                                //@@@                                   ---
+        const uint64_t w = bits[k];                                                 //@@@                                   ---
+        if (__builtin_popcountll(w) < Bit_walk_limit){                              //@@@                                   ---
+            for (uint64_t v = w; v; v &= v-1){                                      //@@@                                   ---
+                const int j = 64*k + lowest_set_bit(v);                             //@@@                                   ---
+                rp += s[j];                                                         //@@@                                   ---
+                rq += c[j];                                                         //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        for (int g = 0; g < 64; g += 8){                                            //@@@                                   ---
+            const __mmask8 byte = __mmask8(w >> g);                                 //@@@                                   ---
+            ap = _mm512_add_pd(ap,_mm512_maskz_loadu_pd(byte,s+64*k+g));            //@@@                                   ---
+            aq = _mm512_add_pd(aq,_mm512_maskz_loadu_pd(byte,c+64*k+g));            //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    P = hsum(ap) + rp;                                                              //@@@                                   ---
+    Q = hsum(aq) + rq;                                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+void sincos_array(int n,const double* x,double* s,double* c)                        //@@@   dispatch on simd_level()        ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    if (simd_level() == Simd_avx512){ sincos_array_avx512(n,x,s,c); return; }       //@@@                                   ---
+    if (simd_level() == Simd_avx2){ sincos_array_avx2(n,x,s,c); return; }           //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    sincos_array_scalar(n,x,s,c);                                                   //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void sum_sincos(int n,const double* x,double& S,double& C)                          //@@@                                   ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    if (simd_level() == Simd_avx512){ sum_sincos_avx512(n,x,S,C); return; }         //@@@                                   ---
+    if (simd_level() == Simd_avx2){ sum_sincos_avx2(n,x,S,C); return; }             //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    sum_sincos_scalar(n,x,S,C);                                                     //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void sum_pair(int n,const double* a,const double* b,double& A,double& B)            //@@@                                   ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    if (simd_level() == Simd_avx512){ sum_pair_avx512(n,a,b,A,B); return; }         //@@@                                   ---
+    if (simd_level() == Simd_avx2){ sum_pair_avx2(n,a,b,A,B); return; }             //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    sum_pair_scalar(n,a,b,A,B);                                                     //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void dot_pair(int n,const double* wc,const double* wsn,const double* s,             //@@@                                   ---
+              const double* c,double& P,double& Q)                                  //@@@                                   ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    if (simd_level() == Simd_avx512){ dot_pair_avx512(n,wc,wsn,s,c,P,Q); return; }  //@@@                                   ---
+    if (simd_level() == Simd_avx2){ dot_pair_avx2(n,wc,wsn,s,c,P,Q); return; }      //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    dot_pair_scalar(n,wc,wsn,s,c,P,Q);                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void bit_pair(int words,const uint64_t* bits,const double* s,const double* c,       //@@@                                   ---
+              double& P,double& Q)                                                  //@@@                                   ---
+{                                                                                   //@@@                                   ---
+#ifdef KURAMOTO_SIMD_X86                                                            //@@@                                   ---
+    if (simd_level() == Simd_avx512){ bit_pair_avx512(words,bits,s,c,P,Q); return; }//@@@                                   ---
+    if (simd_level() == Simd_avx2){ bit_pair_avx2(words,bits,s,c,P,Q); return; }    //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    bit_pair_scalar(words,bits,s,c,P,Q);                                            //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void simd_diagnostics()                                                             //@@@ max ulp of sincos_array vs libm   ---
+{                                                                                   //@@@ over 4e6 points (half in [-pi,pi] ---
+    const int Number_of_point = 4000000, Bench_size = 4096;                         //@@@ half in [-1e4,1e4]) and Gsin/s    ---
+    vector<double> x(Number_of_point), s(Number_of_point), c(Number_of_point);      //@@@ (sin and cos count one each) for  ---
+    unsigned long long seed = 88172645463325252ULL;                                 //@@@ every path this CPU has           ---
+    for (int j = 0; j < Number_of_point; j++){                                      //@@@                                   ---
+        seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;                  //@@@  xorshift64: same points each run ---
+        double u = (seed >> 11)*(1.0/9007199254740992.0);                           //@@@                                   ---
+        x[j] = (j < Number_of_point/2 ? Pi : 1.0e4)*(2.0*u-1.0);                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const Simd_level detected = simd_level();                                       //@@@                                   ---
+    cout << "SIMD path in use: " << Simd_level_name[detected] << endl;              //@@@                                   ---
+    for (int level = Simd_scalar; level <= detected; level++){                      //@@@                                   ---
+        simd_level() = Simd_level(level);                                           //@@@                                   ---
+        sincos_array(Number_of_point,x.data(),s.data(),c.data());                   //@@@                                   ---
+        double max_ulp_sin = 0.0, max_ulp_cos = 0.0;                                //@@@                                   ---
+        for (int j = 0; j < Number_of_point; j++){                                  //@@@                                   ---
+            double rs = sin(x[j]), rc = cos(x[j]);                                  //@@@                                   ---
+            double us = nextafter(fabs(rs),1.0e300) - fabs(rs);                     //@@@     ulp of the libm value         ---
+            double uc = nextafter(fabs(rc),1.0e300) - fabs(rc);                     //@@@                                   ---
+            max_ulp_sin = max(max_ulp_sin,fabs(s[j]-rs)/us);                        //@@@                                   ---
+            max_ulp_cos = max(max_ulp_cos,fabs(c[j]-rc)/uc);                        //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        int repeat = 0;                                                             //@@@                                   ---
+        clock_t start = clock();                                                    //@@@                                   ---
+        do {                                                                        //@@@                                   ---
+            for (int k = 0; k < 64; k++, repeat++)                                  //@@@                                   ---
+                sincos_array(Bench_size,x.data(),s.data(),c.data());                //@@@                                   ---
+        } while (clock() - start < CLOCKS_PER_SEC/4);                               //@@@                                   ---
+        double seconds = double(clock() - start)/CLOCKS_PER_SEC;                    //@@@                                   ---
+        cout << Simd_level_name[level] << "\tmax ulp sin " << max_ulp_sin           //@@@                                   ---
+             << "\tcos " << max_ulp_cos << "\t"                                     //@@@                                   ---
+             << 2.0*Bench_size*repeat/seconds*1.0e-9 << " Gsin/s" << endl;          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    simd_level() = detected;                                                        //@@@                                   ---
+    int repeat = 0;                                                                 //@@@                                   ---
+    clock_t start = clock();                                                        //@@@                                   ---
+    do {                                                                            //@@@                                   ---
+        for (int k = 0; k < 64; k++, repeat++)                                      //@@@                                   ---
+            for (int j = 0; j < Bench_size; j++){                                   //@@@                                   ---
+                s[j] = sin(x[j]);                                                   //@@@                                   ---
+                c[j] = cos(x[j]);                                                   //@@@                                   ---
+            }                                                                       //@@@                                   ---
+    } while (clock() - start < CLOCKS_PER_SEC/4);                                   //@@@                                   ---
+    double seconds = double(clock() - start)/CLOCKS_PER_SEC;                        //@@@                                   ---
+    cout << "libm\t\t\t\t\t" << 2.0*Bench_size*repeat/seconds*1.0e-9                //@@@                                   ---
+         << " Gsin/s" << endl;                                                      //@@@                                   ---
+}                                                                                   //@@@                                   ---
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                                              |    |                                                     $$$$
 //                                                              |    |                                                     $$$$
@@ -67,10 +739,11 @@ double dydt(int specified,int N,double coupling,double W,double L,double B,
 //@@@                                CCRK4                                           @@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 void Runge_Kutta_4(int N,double dt,double coupling,const double* W,const double* L, //@@@                                   ---
-                   const double* B,const double* a,const double* const* b,          //@@@                                   ---
-                   const double* const* A,double* Phase_old,                        //@@@                                   ---
+                   const double* B,const double* a,const Matrix<double>& b,         //@@@                                   ---
+                   const Matrix<double>& A,double* Phase_old,                       //@@@                                   ---
                    double* Phase_old_otherlayer,double* Phase_new)                  //@@@                                   ---
 {                                                                                   //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
     for (int i = 0; i < N; i++)                                                     //@@@                                   ---
         {                                                                           //@@@                                   ---   
             double k1 = dydt(i,N,coupling,W[i],L[i],B[i],a[i],b[i],A[i],            //@@@                                   ---
@@ -84,6 +757,539 @@ void Runge_Kutta_4(int N,double dt,double coupling,const double* W,const double*
             Phase_new[i] = Phase_old[i]+dt/6.0*(k1+2.0*k2+2.0*k3+k4);               //@@@                                   ---
         }                                                                           //@@@                                   ---
 }                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                             Sparse adjacency (CSR)                             @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+struct Sparse_adjacency                                                             //@@@   neighbours of node i are        ---
+{                                                                                   //@@@   col[row_start[i]..[i+1])        ---
+    int Number_of_node = 0;                                                         //@@@                                   ---
+    int Number_of_edge = 0;                                                         //@@@                                   ---
+    vector<int> row_start;                                                          //@@@           [N+1]                   ---
+    vector<int> col;                                                                //@@@            [E]                    ---
+    vector<double> weight;                                                          //@@@   [E] empty when all A_ij = 1     ---
+    vector<double> frustration;                                                     //@@@   [E] empty when all b_ij = 0     ---
+    vector<double> weight_cos;                                                      //@@@   [E] A_ij*cos(b_ij)              ---
+    vector<double> weight_sin;                                                      //@@@   [E] A_ij*sin(b_ij)              ---
+    bool all_to_all = false;                                                        //@@@  complete graph, one weight/b:    ---
+    bool self_coupling = false;                                                     //@@@  edges released, mean field used  ---
+    double uniform_weight = 1.0;                                                    //@@@                                   ---
+    double uniform_frustration = 0.0;                                               //@@@                                   ---
+    bool bit_packed = false;                                                        //@@@  0/1 graph, b=0 (pack_bits):      ---
+    int words_per_row = 0;                                                          //@@@  bit j of bits[i] is A_ij, col    ---
+    Matrix<uint64_t> bits;                                                          //@@@  released, row_start still gives  ---
+};                                                                                  //@@@  the degrees                      ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                              all-to-all detection                              @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+bool detect_all_to_all(Sparse_adjacency& A)                                         //@@@  complete or complete-minus-diag  ---
+{                                                                                   //@@@  with uniform A_ij and b_ij       ---
+    const int N = A.Number_of_node;                                                 //@@@                                   ---
+    if (N == 0 || A.Number_of_edge == 0) return false;                              //@@@                                   ---
+    const int per_row = A.row_start[1] - A.row_start[0];                            //@@@                                   ---
+    if (per_row != N && per_row != N-1) return false;                               //@@@                                   ---
+    const bool self = (per_row == N);                                               //@@@                                   ---
+    const double w0 = A.weight.empty() ? 1.0 : A.weight[0];                         //@@@                                   ---
+    const double b0 = A.frustration.empty() ? 0.0 : A.frustration[0];               //@@@                                   ---
+    for (int i = 0; i < N; i++){                                                    //@@@                                   ---
+        if (A.row_start[i+1] - A.row_start[i] != per_row) return false;             //@@@                                   ---
+        for (int e = A.row_start[i]; e < A.row_start[i+1]; e++){                    //@@@                                   ---
+            if (!self && A.col[e] == i) return false;                               //@@@                                   ---
+            if (!A.weight.empty() && A.weight[e] != w0) return false;               //@@@                                   ---
+            if (!A.frustration.empty() && A.frustration[e] != b0) return false;     //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    A.all_to_all = true;                                                            //@@@                                   ---
+    A.self_coupling = self;                                                         //@@@                                   ---
+    A.uniform_weight = w0;                                                          //@@@                                   ---
+    A.uniform_frustration = b0;                                                     //@@@                                   ---
+    vector<int>().swap(A.col);                                                      //@@@        O(N) memory from here      ---
+    vector<double>().swap(A.weight);                                                //@@@                                   ---
+    vector<double>().swap(A.frustration);                                           //@@@                                   ---
+    vector<double>().swap(A.weight_cos);                                            //@@@                                   ---
+    vector<double>().swap(A.weight_sin);                                            //@@@                                   ---
+    cout << "all-to-all network detected\tdiagonal=" << self <<                     //@@@                                   ---
+    "\tmean-field coupling is used" << endl;                                        //@@@                                   ---
+    return true;                                                                    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                  bit packing                                   @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+const int Bit_pack_density_inverse = 4;                                             //@@@ from density 1/4 the bits take    ---
+bool pack_bits(Sparse_adjacency& A)                                                 //@@@ 1/8 of the CSR columns and the    ---
+{                                                                                   //@@@ masked lanes are at least as fast ---
+    const int N = A.Number_of_node;                                                 //@@@ as the CSR gather (set-bit walks  ---
+    if (A.all_to_all || A.bit_packed || !A.weight.empty() ||                        //@@@ lose below that)                  ---
+        !A.frustration.empty()) return false;                                       //@@@   weighted or frustrated: CSR     ---
+    const int words = (N+63)/64;                                                    //@@@                                   ---
+    if (size_t(A.Number_of_edge)*Bit_pack_density_inverse <                         //@@@                                   ---
+        size_t(N)*Matrix<uint64_t>::padded_stride(words)*64) return false;          //@@@                                   ---
+    Matrix<uint64_t> bits(N,words);                                                 //@@@                                   ---
+    for (int i = 0; i < N; i++){                                                    //@@@                                   ---
+        for (int e = A.row_start[i]; e < A.row_start[i+1]; e++){                    //@@@                                   ---
+            bits[i][A.col[e]/64] |= uint64_t(1) << (A.col[e]%64);                   //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    A.bit_packed = true;                                                            //@@@                                   ---
+    A.words_per_row = words;                                                        //@@@                                   ---
+    A.bits = move(bits);                                                            //@@@                                   ---
+    vector<int>().swap(A.col);                                                      //@@@                                   ---
+    cout << "binary network packed to bits\tKB=" <<                                 //@@@                                   ---
+    size_t(N)*A.bits.stride()/128 << "\tbit-packed coupling is used" << endl;       //@@@                                   ---
+    return true;                                                                    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                 dydt (sparse)                                  @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+double dydt(int specified,int N,double coupling,double W,double L,double B,         //@@@                                   ---
+            double a,const Sparse_adjacency& A,double Phase_old_otherlayer,         //@@@                                   ---
+            double* Phase_old,double Phase_old_specified)                           //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    if (A.all_to_all){                                                              //@@@     every node is a neighbour     ---
+        double summation = 0.0;                                                     //@@@                                   ---
+        for (int j = 0; j < N; j++){                                                //@@@                                   ---
+            if (j == specified && !A.self_coupling) continue;                       //@@@                                   ---
+            summation += A.uniform_weight*sin(Phase_old[j] - Phase_old_specified    //@@@                                   ---
+                                              + A.uniform_frustration);             //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        double connection = (L*B*sin(Phase_old_otherlayer-Phase_old_specified+a));  //@@@                                   ---
+        return W + ((coupling/(N * 1.0))*summation) + connection;                   //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (A.bit_packed){                                                              //@@@    walk the set bits of row i     ---
+        double summation = 0.0;                                                     //@@@                                   ---
+        const uint64_t* row = A.bits[specified];                                    //@@@                                   ---
+        for (int k = 0; k < A.words_per_row; k++){                                  //@@@                                   ---
+            for (uint64_t w = row[k]; w; w &= w-1){                                 //@@@                                   ---
+                summation += sin(Phase_old[64*k + lowest_set_bit(w)]                //@@@                                   ---
+                                 - Phase_old_specified);                            //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        double connection = (L*B*sin(Phase_old_otherlayer-Phase_old_specified+a));  //@@@                                   ---
+        return W + ((coupling/(N * 1.0))*summation) + connection;                   //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const int* col = A.col.data();                                                  //@@@                                   ---
+    const double* weight = A.weight.empty() ? nullptr : A.weight.data();            //@@@                                   ---
+    const double* b = A.frustration.empty() ? nullptr : A.frustration.data();       //@@@                                   ---
+    double summation = 0.0;                                                         //@@@                                   ---
+    for (int e = A.row_start[specified]; e < A.row_start[specified+1]; e++){        //@@@      only stored neighbours       ---
+        double angle = Phase_old[col[e]] - Phase_old_specified;                     //@@@                                   ---
+        if (b) angle += b[e];                                                       //@@@                                   ---
+        summation += (weight ? weight[e] : 1.0) * sin(angle);                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double connection = 0.0;                                                        //@@@                                   ---
+    connection = (L*B*sin(Phase_old_otherlayer-Phase_old_specified+a));             //@@@                                   ---
+    double k = 0;                                                                   //@@@                                   ---
+    k = W + ((coupling/(N * 1.0))*summation) + connection;                          //@@@                                   ---
+    return k;                                                                       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                 CCRK4 (sparse)                                 @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+void Runge_Kutta_4(int N,double dt,double coupling,const double* W,const double* L, //@@@                                   ---
+                   const double* B,const double* a,const Sparse_adjacency& A,       //@@@   b_ij lives in A.frustration     ---
+                   double* Phase_old,double* Phase_old_otherlayer,double* Phase_new)//@@@                                   ---
+{                                                                                   //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int i = 0; i < N; i++)                                                     //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            double k1 = dydt(i,N,coupling,W[i],L[i],B[i],a[i],A,                    //@@@                                   ---
+                          Phase_old_otherlayer[i],Phase_old,Phase_old[i]);          //@@@                                   ---
+            double k2 = dydt(i,N,coupling,W[i],L[i],B[i],a[i],A,                    //@@@                                   ---
+                          Phase_old_otherlayer[i],Phase_old,Phase_old[i]+k1*dt/2.0);//@@@                                   ---
+            double k3 = dydt(i,N,coupling,W[i],L[i],B[i],a[i],A,                    //@@@                                   ---
+                          Phase_old_otherlayer[i],Phase_old,Phase_old[i]+k2*dt/2.0);//@@@                                   ---
+            double k4 = dydt(i,N,coupling,W[i],L[i],B[i],a[i],A,                    //@@@                                   ---
+                          Phase_old_otherlayer[i],Phase_old,Phase_old[i]+k3*dt);    //@@@                                   ---
+            Phase_new[i] = Phase_old[i]+dt/6.0*(k1+2.0*k2+2.0*k3+k4);               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+}                                                                                   //@@@                                   ---
+                                                                                    //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                             Trig-factored coupling                             @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+struct Trig_workspace                                                               //@@@ sin(I_j-I_i+b)=sin(I_j+b)cos(I_i) ---
+{                                                                                   //@@@            -cos(I_j+b)sin(I_i)    ---
+    vector<double> s, c;                                                            //@@@    sin/cos of every phase         ---
+    vector<double> P, Q;                                                            //@@@  P=sum A sin(I_j+b) Q=sum A cos   ---
+    Reduction_workspace red;                                                        //@@@        mean-field block sums      ---
+    explicit Trig_workspace(int N = 0) { resize(N); }                               //@@@                                   ---
+    void resize(int N){                                                             //@@@                                   ---
+        s.assign(N,0.0); c.assign(N,0.0); P.assign(N,0.0); Q.assign(N,0.0);         //@@@                                   ---
+        red = Reduction_workspace(N);                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+};                                                                                  //@@@                                   ---
+struct Dense_trig_weights                                                           //@@@    (A o cos b) and (A o sin b)    ---
+{                                                                                   //@@@                                   ---
+    int N = 0;                                                                      //@@@                                   ---
+    Matrix<double> Wc;                                                              //@@@                                   ---
+    Matrix<double> Ws;                                                              //@@@                                   ---
+};                                                                                  //@@@                                   ---
+Dense_trig_weights make_trig_weights(const Matrix<double>& A,                       //@@@                                   ---
+                                     const Matrix<double>& b,int N)                 //@@@  once, from read_2D_A/read_2D_b   ---
+{                                                                                   //@@@                                   ---
+    Dense_trig_weights T;                                                           //@@@                                   ---
+    T.N = N;                                                                        //@@@                                   ---
+    T.Wc = Matrix<double>(N,N);                                                     //@@@                                   ---
+    T.Ws = Matrix<double>(N,N);                                                     //@@@                                   ---
+    for (int i = 0; i < N; i++){                                                    //@@@                                   ---
+        for (int j = 0; j < N; j++){                                                //@@@                                   ---
+            T.Wc[i][j] = A[i][j]*cos(b[i][j]);                                      //@@@                                   ---
+            T.Ws[i][j] = A[i][j]*sin(b[i][j]);                                      //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    return T;                                                                       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void precompute_trig_weights(Sparse_adjacency& A)                                   //@@@   per edge, once after loading    ---
+{                                                                                   //@@@                                   ---
+    if (A.frustration.empty()) return;                                              //@@@  b=0: weights alone are enough    ---
+    A.weight_cos.resize(A.Number_of_edge);                                          //@@@                                   ---
+    A.weight_sin.resize(A.Number_of_edge);                                          //@@@                                   ---
+    for (int e = 0; e < A.Number_of_edge; e++){                                     //@@@                                   ---
+        double w = A.weight.empty() ? 1.0 : A.weight[e];                            //@@@                                   ---
+        A.weight_cos[e] = w*cos(A.frustration[e]);                                  //@@@                                   ---
+        A.weight_sin[e] = w*sin(A.frustration[e]);                                  //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void trig_of_phases(int N,const double* Phase_old,Trig_workspace& ws)               //@@@    N sin + N cos per step         ---
+{                                                                                   //@@@                                   ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int k = 0; k < blocks; k++){                                               //@@@                                   ---
+        const int first = k*Reduction_block;                                        //@@@                                   ---
+        sincos_array(min(N-first,Reduction_block),Phase_old+first,                  //@@@    SIMD, block by block           ---
+                     ws.s.data()+first,ws.c.data()+first);                          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void neighbour_sums(const Dense_trig_weights& T,Trig_workspace& ws)                 //@@@  P=Wc.s+Ws.c   Q=Wc.c-Ws.s        ---
+{                                                                                   //@@@                                   ---
+    const double* s = ws.s.data();                                                  //@@@                                   ---
+    const double* c = ws.c.data();                                                  //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int i = 0; i < T.N; i++)                                                   //@@@                                   ---
+        dot_pair(T.N,T.Wc[i],T.Ws[i],s,c,ws.P[i],ws.Q[i]);                          //@@@  one fused FMA pass over the row  ---
+}                                                                                   //@@@                                   ---
+void mean_field_sums(const Sparse_adjacency& A,Trig_workspace& ws)                  //@@@  Z=sum e^(iI_j)=N r e^(i psi)     ---
+{                                                                                   //@@@  P=w Im(e^(ib)Z) Q=w Re(e^(ib)Z)  ---
+    const int N = A.Number_of_node;                                                 //@@@                                   ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int k = 0; k < blocks; k++){                                               //@@@                                   ---
+        const int first = k*Reduction_block;                                        //@@@                                   ---
+        sum_pair(min(N-first,Reduction_block),ws.s.data()+first,                    //@@@                                   ---
+                 ws.c.data()+first,ws.red.part_x[k],ws.red.part_y[k]);              //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    reduce_blocks(blocks,ws.red);                                                   //@@@                                   ---
+    const double rs = ws.red.x, rc = ws.red.y;                                      //@@@                                   ---
+    const double wc = A.uniform_weight*cos(A.uniform_frustration);                  //@@@                                   ---
+    const double wsn = A.uniform_weight*sin(A.uniform_frustration);                 //@@@                                   ---
+    const double P = wc*rs + wsn*rc;                                                //@@@                                   ---
+    const double Q = wc*rc - wsn*rs;                                                //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int i = 0; i < N; i++){                                                    //@@@                                   ---
+        ws.P[i] = P;                                                                //@@@                                   ---
+        ws.Q[i] = Q;                                                                //@@@                                   ---
+        if (!A.self_coupling){                                                      //@@@        remove own term            ---
+            ws.P[i] -= wc*ws.s[i] + wsn*ws.c[i];                                    //@@@                                   ---
+            ws.Q[i] -= wc*ws.c[i] - wsn*ws.s[i];                                    //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+inline void row_sums(const Sparse_adjacency& A,int i,const double* s,               //@@@ P and Q of one stored row: bits   ---
+                     const double* c,double& P_i,double& Q_i)                       //@@@ or CSR (weighted, frustrated)     ---
+{                                                                                   //@@@                                   ---
+    if (A.bit_packed){                                                              //@@@                                   ---
+        bit_pair(A.words_per_row,A.bits[i],s,c,P_i,Q_i);                            //@@@                                   ---
+        return;                                                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const int* col = A.col.data();                                                  //@@@                                   ---
+    double P = 0.0, Q = 0.0;                                                        //@@@                                   ---
+    if (!A.weight_cos.empty()){                                                     //@@@                                   ---
+        const double* wc = A.weight_cos.data();                                     //@@@                                   ---
+        const double* wsn = A.weight_sin.data();                                    //@@@                                   ---
+        for (int e = A.row_start[i]; e < A.row_start[i+1]; e++){                    //@@@                                   ---
+            P += wc[e]*s[col[e]] + wsn[e]*c[col[e]];                                //@@@                                   ---
+            Q += wc[e]*c[col[e]] - wsn[e]*s[col[e]];                                //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }else if (!A.weight.empty()){                                                   //@@@                                   ---
+        const double* w = A.weight.data();                                          //@@@                                   ---
+        for (int e = A.row_start[i]; e < A.row_start[i+1]; e++){                    //@@@                                   ---
+            P += w[e]*s[col[e]];                                                    //@@@                                   ---
+            Q += w[e]*c[col[e]];                                                    //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }else{                                                                          //@@@                                   ---
+        for (int e = A.row_start[i]; e < A.row_start[i+1]; e++){                    //@@@                                   ---
+            P += s[col[e]];                                                         //@@@                                   ---
+            Q += c[col[e]];                                                         //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    P_i = P;                                                                        //@@@                                   ---
+    Q_i = Q;                                                                        //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void neighbour_sums(const Sparse_adjacency& A,Trig_workspace& ws)                   //@@@ same, stored edges only           ---
+{                                                                                   //@@@                                   ---
+    if (A.all_to_all){                                                              //@@@ O(N) per step                     ---
+        mean_field_sums(A,ws);                                                      //@@@                                   ---
+        return;                                                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int i = 0; i < A.Number_of_node; i++)                                      //@@@                                   ---
+        row_sums(A,i,ws.s.data(),ws.c.data(),ws.P[i],ws.Q[i]);                      //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                dydt (factored)                                 @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+inline double dydt_factored(double W,double coupling_over_N,double P,double Q,      //@@@                                   ---
+                            double L,double B,double a,double Phase_old_otherlayer, //@@@                                   ---
+                            double Phase_old_specified)                             //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    double summation = P*cos(Phase_old_specified) - Q*sin(Phase_old_specified);     //@@@     O(1) instead of O(N)          ---
+    double connection = (L*B*sin(Phase_old_otherlayer-Phase_old_specified+a));      //@@@                                   ---
+    return W + coupling_over_N*summation + connection;                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                CCRK4 (factored)                                @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+void RK4_stages_factored(int N,double dt,double coupling,const double* W,           //@@@                                   ---
+                         const double* L,const double* B,const double* a,           //@@@                                   ---
+                         double* Phase_old,double* Phase_old_otherlayer,            //@@@                                   ---
+                         double* Phase_new,const Trig_workspace& ws)                //@@@  k1..k4 reuse the same P and Q    ---
+{                                                                                   //@@@                                   ---
+    const double KN = coupling/(N * 1.0);                                           //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int i = 0; i < N; i++)                                                     //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            const double P = ws.P[i], Q = ws.Q[i];                                  //@@@                                   ---
+            double k1 = dydt_factored(W[i],KN,P,Q,L[i],B[i],a[i],                   //@@@                                   ---
+                            Phase_old_otherlayer[i],Phase_old[i]);                  //@@@                                   ---
+            double k2 = dydt_factored(W[i],KN,P,Q,L[i],B[i],a[i],                   //@@@                                   ---
+                            Phase_old_otherlayer[i],Phase_old[i]+k1*dt/2.0);        //@@@                                   ---
+            double k3 = dydt_factored(W[i],KN,P,Q,L[i],B[i],a[i],                   //@@@                                   ---
+                            Phase_old_otherlayer[i],Phase_old[i]+k2*dt/2.0);        //@@@                                   ---
+            double k4 = dydt_factored(W[i],KN,P,Q,L[i],B[i],a[i],                   //@@@                                   ---
+                            Phase_old_otherlayer[i],Phase_old[i]+k3*dt);            //@@@                                   ---
+            Phase_new[i] = Phase_old[i]+dt/6.0*(k1+2.0*k2+2.0*k3+k4);               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void Runge_Kutta_4_factored(int N,double dt,double coupling,const double* W,        //@@@                                   ---
+                            const double* L,const double* B,const double* a,        //@@@                                   ---
+                            const Dense_trig_weights& T,double* Phase_old,          //@@@                                   ---
+                            double* Phase_old_otherlayer,double* Phase_new,         //@@@                                   ---
+                            Trig_workspace& ws)                                     //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    trig_of_phases(N,Phase_old,ws);                                                 //@@@                                   ---
+    neighbour_sums(T,ws);                                                           //@@@                                   ---
+    RK4_stages_factored(N,dt,coupling,W,L,B,a,Phase_old,Phase_old_otherlayer,       //@@@                                   ---
+                        Phase_new,ws);                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void Runge_Kutta_4_factored(int N,double dt,double coupling,const double* W,        //@@@                                   ---
+                            const double* L,const double* B,const double* a,        //@@@                                   ---
+                            const Sparse_adjacency& A,double* Phase_old,            //@@@                                   ---
+                            double* Phase_old_otherlayer,double* Phase_new,         //@@@                                   ---
+                            Trig_workspace& ws)                                     //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    trig_of_phases(N,Phase_old,ws);                                                 //@@@                                   ---
+    neighbour_sums(A,ws);                                                           //@@@                                   ---
+    RK4_stages_factored(N,dt,coupling,W,L,B,a,Phase_old,Phase_old_otherlayer,       //@@@                                   ---
+                        Phase_new,ws);                                              //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                              Multiplex (M layers)                              @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+struct Interlayer_link                                                              //@@@ node indices are layer*N+i        ---
+{                                                                                   //@@@                                   ---
+    int target, source;                                                             //@@@ source pulls target               ---
+    double weight;                                                                  //@@@ L*B of the two-layer model        ---
+    double frustration;                                                             //@@@ a                                 ---
+};                                                                                  //@@@                                   ---
+struct Interlayer_links                                                             //@@@ CSR over the M*N target nodes:    ---
+{                                                                                   //@@@ links of g are                    ---
+    vector<int> start;                                                              //@@@ [start[g]..start[g+1])            ---
+    vector<int> source;                                                             //@@@                                   ---
+    vector<double> weight;                                                          //@@@                                   ---
+    vector<double> frustration;                                                     //@@@                                   ---
+};                                                                                  //@@@                                   ---
+Interlayer_links make_interlayer_links(int Number_of_phase,                         //@@@ counting sort by target, file or  ---
+                                       const vector<Interlayer_link>& list)         //@@@ builder order kept per target     ---
+{                                                                                   //@@@                                   ---
+    Interlayer_links X;                                                             //@@@                                   ---
+    X.start.assign(Number_of_phase+1,0);                                            //@@@                                   ---
+    for (const Interlayer_link& l : list)                                           //@@@                                   ---
+        if (l.weight != 0) X.start[l.target+1]++;                                   //@@@ B=0 or L=0: no link stored        ---
+    for (int g = 0; g < Number_of_phase; g++) X.start[g+1] += X.start[g];           //@@@                                   ---
+    X.source.resize(X.start[Number_of_phase]);                                      //@@@                                   ---
+    X.weight.resize(X.start[Number_of_phase]);                                      //@@@                                   ---
+    X.frustration.resize(X.start[Number_of_phase]);                                 //@@@                                   ---
+    vector<int> next(X.start.begin(),X.start.end()-1);                              //@@@                                   ---
+    for (const Interlayer_link& l : list){                                          //@@@                                   ---
+        if (l.weight == 0) continue;                                                //@@@                                   ---
+        const int e = next[l.target]++;                                             //@@@                                   ---
+        X.source[e] = l.source;                                                     //@@@                                   ---
+        X.weight[e] = l.weight;                                                     //@@@                                   ---
+        X.frustration[e] = l.frustration;                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    return X;                                                                       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void add_one_to_one_links(vector<Interlayer_link>& list,int N,int target_layer,     //@@@ node i of target_layer pulled by  ---
+                          int source_layer,const double* L,const double* B,         //@@@ node i of source_layer with       ---
+                          const double* a)                                          //@@@ L_i*B_i*sin(I_src-I_i+a_i)        ---
+{                                                                                   //@@@                                   ---
+    for (int i = 0; i < N; i++)                                                     //@@@                                   ---
+        list.push_back({target_layer*N+i,source_layer*N+i,L[i]*B[i],a[i]});         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+struct Mean_field                                                                   //@@@ P=wc*rs+wsn*rc  Q=wc*rc-wsn*rs    ---
+{                                                                                   //@@@                                   ---
+    double wc = 0.0, wsn = 0.0, P = 0.0, Q = 0.0;                                   //@@@                                   ---
+};                                                                                  //@@@                                   ---
+struct Multiplex                                                                    //@@@ M layers of N nodes, one phase    ---
+{                                                                                   //@@@ vector: g = layer*N + i           ---
+    int M = 0, N = 0;                                                               //@@@                                   ---
+    vector<Sparse_adjacency> layer;                                                 //@@@ [M] intralayer A and b            ---
+    vector<double> W;                                                               //@@@ [M*N] natural frequencies         ---
+    Interlayer_links links;                                                         //@@@                                   ---
+    bool gauss_seidel = true;                                                       //@@@ layer m sees the new phases of    ---
+    vector<double> phase, phase_next;                                               //@@@ layers < m (two-layer order);     ---
+    vector<double> s, c, P, Q;                                                      //@@@ false: all layers from old ones   ---
+    vector<double> s_next, c_next;                                                  //@@@ sin/cos of the new phases         ---
+    bool trig_current = false;                                                      //@@@ s,c belong to phase; set false    ---
+    vector<Reduction_workspace> red;                                                //@@@ [M] sum sin, sum cos by block:    ---
+    vector<Mean_field> field;                                                       //@@@ mean field and order parameter    ---
+    Multiplex(int Number_of_layer,int Number_of_node)                               //@@@                                   ---
+        : M(Number_of_layer), N(Number_of_node), layer(Number_of_layer),            //@@@                                   ---
+          W(size_t(M)*N,0.0), phase(size_t(M)*N,0.0), phase_next(size_t(M)*N,0.0),  //@@@                                   ---
+          s(size_t(M)*N,0.0), c(size_t(M)*N,0.0), P(size_t(M)*N,0.0),               //@@@                                   ---
+          Q(size_t(M)*N,0.0), s_next(size_t(M)*N,0.0), c_next(size_t(M)*N,0.0),     //@@@                                   ---
+          red(Number_of_layer,Reduction_workspace(Number_of_node)),                 //@@@                                   ---
+          field(Number_of_layer) {}                                                 //@@@                                   ---
+    double* phases(int m) { return phase.data() + size_t(m)*N; }                    //@@@                                   ---
+    int size() const { return M*N; }                                                //@@@                                   ---
+};                                                                                  //@@@                                   ---
+inline double wrap_phase(double phi)                                                //@@@ to -pi..pi, as check_scale        ---
+{                                                                                   //@@@                                   ---
+    while(abs(phi)>Pi){                                                             //@@@                                   ---
+        if (phi>0){                                                                 //@@@                                   ---
+            phi=phi-2*Pi;                                                           //@@@                                   ---
+        }else if(phi<0){                                                            //@@@                                   ---
+            phi=phi+2*Pi;                                                           //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    return phi;                                                                     //@@@                                   ---
+}                                                                                   //@@@                                   ---
+inline double dydt_multiplex(const Multiplex& X,int g,double coupling_over_N,       //@@@ intralayer factored as in         ---
+                             double P,double Q,int fresh,                           //@@@ dydt_factored, links direct       ---
+                             double Phase_old_specified)                            //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    double summation = P*cos(Phase_old_specified) - Q*sin(Phase_old_specified);     //@@@                                   ---
+    double connection = 0.0;                                                        //@@@                                   ---
+    for (int l = X.links.start[g]; l < X.links.start[g+1]; l++){                    //@@@                                   ---
+        const int j = X.links.source[l];                                            //@@@                                   ---
+        const double other = j < fresh ? X.phase_next[j] : X.phase[j];              //@@@ below fresh: already updated      ---
+        connection += X.links.weight[l]*sin(other-Phase_old_specified               //@@@                                   ---
+                                            +X.links.frustration[l]);               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    return X.W[g] + coupling_over_N*summation + connection;                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void multiplex_trig(Multiplex& X)                                                   //@@@ sin/cos and block sums of all     ---
+{                                                                                   //@@@ M*N phases (first step only)      ---
+    const int M = X.M, N = X.N;                                                     //@@@                                   ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int k = 0; k < M*blocks; k++){                                             //@@@                                   ---
+        const int m = k / blocks, b = k - m*blocks;                                 //@@@                                   ---
+        const int n = min(N-b*Reduction_block,Reduction_block);                     //@@@                                   ---
+        const size_t first = size_t(m)*N + size_t(b)*Reduction_block;               //@@@                                   ---
+        sincos_array(n,X.phase.data()+first,X.s.data()+first,X.c.data()+first);     //@@@                                   ---
+        sum_pair(n,X.s.data()+first,X.c.data()+first,                               //@@@                                   ---
+                 X.red[m].part_x[b],X.red[m].part_y[b]);                            //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void multiplex_stages(Multiplex& X,double dt,double coupling,                       //@@@ RK4 of layers [first,last), block ---
+                      int first_layer,int last_layer)                               //@@@ by block, with sin/cos of the     ---
+{                                                                                   //@@@ new (wrapped) phases and their    ---
+    const int N = X.N;                                                              //@@@ block sums for the next step      ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@                                   ---
+    const double KN = coupling/(N * 1.0);                                           //@@@                                   ---
+    const int fresh = X.gauss_seidel ? first_layer*N : 0;                           //@@@                                   ---
+    const double* Phase_old = X.phase.data();                                       //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int k = first_layer*blocks; k < last_layer*blocks; k++){                   //@@@                                   ---
+        const int m = k / blocks, b = k - m*blocks;                                 //@@@                                   ---
+        const int n = min(N-b*Reduction_block,Reduction_block);                     //@@@                                   ---
+        const int first = m*N + b*Reduction_block;                                  //@@@                                   ---
+        double wrapped[Reduction_block];                                            //@@@                                   ---
+        for (int g = first; g < first+n; g++)                                       //@@@                                   ---
+            {                                                                       //@@@                                   ---
+                const double P = X.P[g], Q = X.Q[g];                                //@@@                                   ---
+                double k1 = dydt_multiplex(X,g,KN,P,Q,fresh,Phase_old[g]);          //@@@                                   ---
+                double k2 = dydt_multiplex(X,g,KN,P,Q,fresh,Phase_old[g]+k1*dt/2.0);//@@@                                   ---
+                double k3 = dydt_multiplex(X,g,KN,P,Q,fresh,Phase_old[g]+k2*dt/2.0);//@@@                                   ---
+                double k4 = dydt_multiplex(X,g,KN,P,Q,fresh,Phase_old[g]+k3*dt);    //@@@                                   ---
+                X.phase_next[g] = Phase_old[g]+dt/6.0*(k1+2.0*k2+2.0*k3+k4);        //@@@                                   ---
+                wrapped[g-first] = wrap_phase(X.phase_next[g]);                     //@@@ as check_scale will leave it      ---
+            }                                                                       //@@@                                   ---
+        sincos_array(n,wrapped,X.s_next.data()+first,X.c_next.data()+first);        //@@@                                   ---
+        sum_pair(n,X.s_next.data()+first,X.c_next.data()+first,                     //@@@                                   ---
+                 X.red[m].part_x[b],X.red[m].part_y[b]);                            //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void multiplex_step(Multiplex& X,double dt,double coupling)                         //@@@ one RK4 step of every layer:      ---
+{                                                                                   //@@@ one sum pass over all M*N nodes,  ---
+    const int M = X.M, N = X.N;                                                     //@@@ then the stages (M passes Gauss-  ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@ Seidel, one pass Jacobi), which   ---
+    if (!X.trig_current) multiplex_trig(X);                                         //@@@ also give the next step's trig    ---
+    #pragma omp single                                                              //@@@                                   ---
+    {                                                                               //@@@                                   ---
+    for (int m = 0; m < M; m++){                                                    //@@@                                   ---
+        const Sparse_adjacency& A = X.layer[m];                                     //@@@                                   ---
+        if (!A.all_to_all) continue;                                                //@@@                                   ---
+        double rs = 0.0, rc = 0.0;                                                  //@@@                                   ---
+        for (int b = 0; b < blocks; b++){                                           //@@@ block order as reduce_blocks      ---
+            rs += X.red[m].part_x[b];                                               //@@@                                   ---
+            rc += X.red[m].part_y[b];                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        Mean_field& F = X.field[m];                                                 //@@@                                   ---
+        F.wc = A.uniform_weight*cos(A.uniform_frustration);                         //@@@                                   ---
+        F.wsn = A.uniform_weight*sin(A.uniform_frustration);                        //@@@                                   ---
+        F.P = F.wc*rs + F.wsn*rc;                                                   //@@@                                   ---
+        F.Q = F.wc*rc - F.wsn*rs;                                                   //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int g = 0; g < M*N; g++){                                                  //@@@                                   ---
+        const int m = g / N, i = g - m*N;                                           //@@@                                   ---
+        const Sparse_adjacency& A = X.layer[m];                                     //@@@                                   ---
+        const double* s = X.s.data() + size_t(m)*N;                                 //@@@                                   ---
+        const double* c = X.c.data() + size_t(m)*N;                                 //@@@                                   ---
+        if (A.all_to_all){                                                          //@@@                                   ---
+            const Mean_field& F = X.field[m];                                       //@@@                                   ---
+            X.P[g] = F.P;                                                           //@@@                                   ---
+            X.Q[g] = F.Q;                                                           //@@@                                   ---
+            if (!A.self_coupling){                                                  //@@@ remove own term                   ---
+                X.P[g] -= F.wc*s[i] + F.wsn*c[i];                                   //@@@                                   ---
+                X.Q[g] -= F.wc*c[i] - F.wsn*s[i];                                   //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }else{                                                                      //@@@                                   ---
+            row_sums(A,i,s,c,X.P[g],X.Q[g]);                                        //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (X.gauss_seidel){                                                            //@@@                                   ---
+        for (int m = 0; m < M; m++)                                                 //@@@                                   ---
+            multiplex_stages(X,dt,coupling,m,m+1);                                  //@@@                                   ---
+    }else{                                                                          //@@@                                   ---
+        multiplex_stages(X,dt,coupling,0,M);                                        //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    #pragma omp single                                                              //@@@ implicit barrier after single     ---
+    {                                                                               //@@@                                   ---
+    X.phase.swap(X.phase_next);                                                     //@@@                                   ---
+    X.s.swap(X.s_next);                                                             //@@@                                   ---
+    X.c.swap(X.c_next);                                                             //@@@                                   ---
+    X.trig_current = true;                                                          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double multiplex_order_parameter(Multiplex& X,int m)                                //@@@ r of layer m from the block sums  ---
+{                                                                                   //@@@ of the last step: no pass over    ---
+    reduce_blocks((X.N+Reduction_block-1)/Reduction_block,X.red[m]);                //@@@ the phases, no sin/cos            ---
+    return sqrt(X.red[m].x*X.red[m].x + X.red[m].y*X.red[m].y) / (1.0 * X.N);       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+                                                                                    //@@@                                   ---
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                                              |    |                                                     $$$$
 //                                                              |    |                                                     $$$$
@@ -106,16 +1312,9 @@ void Runge_Kutta_4(int N,double dt,double coupling,const double* W,const double*
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 void check_scale(int N, double* phi)                                                //@@@                                   ---
 {                                                                                   //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
     for (int i = 0; i < N; i++)                                                     //@@@                                   ---
-    {                                                                               //@@@                                   ---
-        while(abs(phi[i])>Pi){                                                      //@@@                                   ---
-            if (phi[i]>0){                                                          //@@@                                   ---
-                phi[i]=phi[i]-2*Pi;                                                 //@@@                                   ---
-            }else if(phi[i]<0){                                                     //@@@                                   ---
-                phi[i]=phi[i]+2*Pi;                                                 //@@@                                   ---
-            }                                                                       //@@@                                   ---
-        }                                                                           //@@@                                   ---
-    }                                                                               //@@@                                   ---
+        phi[i] = wrap_phase(phi[i]);                                                //@@@                                   ---
 }                                                                                   //@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 //@@@                                order_parameter                                 @@@@                                   ---
@@ -128,14 +1327,545 @@ double order_parameter(int N, double* phi)
         rc += cos(phi[j]);                                                          //@@@                                   ---
         rs += sin(phi[j]);                                                          //@@@                                   ---
     }                                                                               //@@@                                   ---
-    return sqrt(pow(rc, 2) + pow(rs, 2)) / (1.0 * N);                               //@@@                                   ---
+    return sqrt(rc*rc + rs*rs) / (1.0 * N);                                         //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double order_parameter(int N,const double* phi,Reduction_workspace& red)            //@@@  block reduction, called by every ---
+{                                                                                   //@@@  thread of the parallel region    ---
+    const int blocks = (N+Reduction_block-1)/Reduction_block;                       //@@@                                   ---
+    #pragma omp for schedule(static)                                                //@@@                                   ---
+    for (int k = 0; k < blocks; k++){                                               //@@@                                   ---
+        const int first = k*Reduction_block;                                        //@@@     sum cos and sum sin of the    ---
+        sum_sincos(min(N-first,Reduction_block),phi+first,                          //@@@     block in one SIMD pass        ---
+                   red.part_y[k],red.part_x[k]);                                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    reduce_blocks(blocks,red);                                                      //@@@                                   ---
+    return sqrt(red.x*red.x + red.y*red.y) / (1.0 * N);                             //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                  steady state                                  @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+const double Steady_z = 1.96;                                                       //@@@ 95% confidence                    ---
+const int Steady_first_check = 200;                                                 //@@@ then every 10% more samples       ---
+const int Steady_max_lag = 1000;                                                    //@@@ longest lag summed: O(n*max lag)  ---
+void mean_variance(int n,const double* x,double& mean,double& variance)             //@@@ population variance               ---
+{                                                                                   //@@@                                   ---
+    double m = 0.0;                                                                 //@@@                                   ---
+    for (int t = 0; t < n; t++) m += x[t];                                          //@@@                                   ---
+    m /= n;                                                                         //@@@                                   ---
+    double v = 0.0;                                                                 //@@@                                   ---
+    for (int t = 0; t < n; t++) v += (x[t]-m)*(x[t]-m);                             //@@@                                   ---
+    mean = m;                                                                       //@@@                                   ---
+    variance = v/n;                                                                 //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double effective_sample_size(int n,const double* x,double mean,double variance)     //@@@ n/tau, tau=1+2 sum rho_k summed   ---
+{                                                                                   //@@@ in pairs until a pair turns       ---
+    if (variance <= 0.0 || n < 4) return n;                                         //@@@ negative (Geyer), up to           ---
+    auto rho = [&](int k){                                                          //@@@ Steady_max_lag. Still correlated  ---
+        double a = 0.0;                                                             //@@@ there: tau >= Steady_max_lag,     ---
+        for (int t = 0; t+k < n; t++) a += (x[t]-mean)*(x[t+k]-mean);               //@@@ the safe (wide) side              ---
+        return a/(n*variance);                                                      //@@@                                   ---
+    };                                                                              //@@@                                   ---
+    const int last_lag = min(n/2,Steady_max_lag);                                   //@@@                                   ---
+    double tau = -1.0;                                                              //@@@                                   ---
+    bool cut = true;                                                                //@@@                                   ---
+    for (int k = 0; k+1 < last_lag; k += 2){                                        //@@@                                   ---
+        const double pair = (k == 0 ? 1.0 : rho(k)) + rho(k+1);                     //@@@                                   ---
+        if (pair <= 0.0){ cut = false; break; }                                     //@@@                                   ---
+        tau += 2.0*pair;                                                            //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (cut && last_lag == Steady_max_lag) tau = max(tau,double(Steady_max_lag));   //@@@                                   ---
+    return n/max(tau,1.0);                                                          //@@@                                   ---
 }                                                                                   //@@@                                   ---
+struct Steady_state                                                                 //@@@ r(t), one sample per step. Each   ---
+{                                                                                   //@@@ check takes the last 80% (as the  ---
+    double tolerance = 0.0;                                                         //@@@ average), stationary when its     ---
+    vector<double> r;                                                               //@@@ halves agree in mean and variance ---
+    size_t next_check = Steady_first_check;                                         //@@@ and the 95% half-width of its     ---
+    double mean = 0.0, half_width = 0.0, effective_samples = 0.0;                   //@@@ mean is below tolerance           ---
+    explicit Steady_state(double Tolerance = 0.0) : tolerance(Tolerance) {}         //@@@ 0 = off (full time horizon)       ---
+    bool enabled() const { return tolerance > 0.0; }                                //@@@                                   ---
+    void reset(){                                                                   //@@@                                   ---
+        r.clear();                                                                  //@@@                                   ---
+        next_check = Steady_first_check;                                            //@@@                                   ---
+        mean = half_width = effective_samples = 0.0;                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    bool add(double sample){                                                        //@@@ true once settled                 ---
+        if (!enabled()) return false;                                               //@@@                                   ---
+        r.push_back(sample);                                                        //@@@                                   ---
+        if (r.size() < next_check) return false;                                    //@@@                                   ---
+        next_check = r.size() + max(r.size()/10,size_t(1));                         //@@@                                   ---
+        return settled();                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    bool settled(){                                                                 //@@@                                   ---
+        const size_t first = r.size()/5;                                            //@@@ transient cut                     ---
+        const int n = int(r.size()-first), h = n/2;                                 //@@@                                   ---
+        const double* x = r.data()+first;                                           //@@@                                   ---
+        double m1, v1, m2, v2;                                                      //@@@                                   ---
+        mean_variance(h,x,m1,v1);                                                   //@@@                                   ---
+        mean_variance(n-h,x+h,m2,v2);                                               //@@@                                   ---
+        const double se = sqrt(v1/effective_sample_size(h,x,m1,v1) +                //@@@                                   ---
+                               v2/effective_sample_size(n-h,x+h,m2,v2));            //@@@                                   ---
+        if (fabs(m1-m2) > max(Steady_z*se,0.1*tolerance)) return false;             //@@@ mean still drifting               ---
+        if (max(v1,v2) > tolerance*tolerance &&                                     //@@@                                   ---
+            max(v1,v2) > 2.0*min(v1,v2)) return false;                              //@@@ variance still drifting           ---
+        double v;                                                                   //@@@                                   ---
+        mean_variance(n,x,mean,v);                                                  //@@@                                   ---
+        effective_samples = effective_sample_size(n,x,mean,v);                      //@@@                                   ---
+        half_width = Steady_z*sqrt(v/effective_samples);                            //@@@                                   ---
+        return half_width < tolerance;                                              //@@@                                   ---
+    }                                                                               //@@@                                   ---
+};                                                                                  //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                               trajectory writer                                @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+enum Trajectory_format {                                                            //@@@ data[10], phases of every step:   ---
+    Trajectory_text = 0,                                                            //@@@ .txt  time, 2 decimals per node   ---
+    Trajectory_float64 = 1,                                                         //@@@ .bin  8 bytes per node            ---
+    Trajectory_float32 = 2,                                                         //@@@ .bin  4 bytes per node            ---
+    Trajectory_int16 = 3                                                            //@@@ .bin  round(phase*scale), 2 bytes ---
+};                                                                                  //@@@                                   ---
+const double Trajectory_int16_scale = 10000.0;                                      //@@@ pi*scale < 32767: 1e-4 resolution ---
+struct Trajectory_header                                                            //@@@ 72 bytes at the top of each .bin, ---
+{                                                                                   //@@@ host byte order (little endian);  ---
+    char magic[4] = {'K','T','R','J'};                                              //@@@ if N < nodes, N uint32 node       ---
+    uint32_t version = 2;                                                           //@@@ indices (0-based) follow it       ---
+    uint32_t N = 0, nodes = 0;                                                      //@@@ recorded / all nodes of the layer ---
+    uint32_t layer = 0, format = 0, stride = 1, unused = 0;                         //@@@                                   ---
+    uint64_t first_step = 0, frames = 0;                                            //@@@ frame f: step first_step+f*stride ---
+    double dt = 0.0, coupling = 0.0, scale = 1.0;                                   //@@@ phase = stored value / scale      ---
+};                                                                                  //@@@                                   ---
+static_assert(sizeof(Trajectory_header) == 72,                                      //@@@                                   ---
+              "Trajectory_header must stay 72 bytes");                              //@@@                                   ---
+struct Recording_policy                                                             //@@@ which steps and nodes reach the   ---
+{                                                                                   //@@@ phase files                       ---
+    long first_step = 0, last_step = -1;                                            //@@@ window in steps, -1 = to the end  ---
+    int stride = 1;                                                                 //@@@ each stride-th step of the window ---
+    long keep_last = 0;                                                             //@@@ >0: only the final frames, kept   ---
+    vector<int> nodes;                                                              //@@@ in memory until close(); nodes:   ---
+    bool wanted(long step) const {                                                  //@@@ 0-based ids, empty = all          ---
+        return step >= first_step && (last_step < 0 || step <= last_step) &&        //@@@                                   ---
+               (step-first_step) % stride == 0;                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+};                                                                                  //@@@                                   ---
+Recording_policy make_recording_policy(const double* data,vector<int> Nodes)        //@@@ data[11] t_start  data[12] stride ---
+{                                                                                   //@@@ data[13] t_end (0 = end)          ---
+    Recording_policy policy;                                                        //@@@ data[14] final T kept (0 = all)   ---
+    const double dt = data[3];                                                      //@@@                                   ---
+    if (data[0] >= 11) policy.first_step = max(lround(data[11]/dt),0L);             //@@@                                   ---
+    if (data[0] >= 12) policy.stride = max(int(data[12]),1);                        //@@@                                   ---
+    if (data[0] >= 13 && data[13] > 0) policy.last_step = lround(data[13]/dt);      //@@@                                   ---
+    if (data[0] >= 14 && data[14] > 0)                                              //@@@                                   ---
+        policy.keep_last = max(lround(data[14]/(dt*policy.stride)),1L);             //@@@                                   ---
+    policy.nodes = Nodes;                                                           //@@@                                   ---
+    return policy;                                                                  //@@@                                   ---
+}                                                                                   //@@@                                   ---
+class Trajectory_writer                                                             //@@@ one file per layer and coupling   ---
+{                                                                                   //@@@                                   ---
+public:                                                                             //@@@                                   ---
+    Trajectory_writer(string Filename,int Format,int N,int Layer,double dt,         //@@@ Filename without extension        ---
+                      double Coupling,const Recording_policy& Policy)               //@@@                                   ---
+        : policy(Policy)                                                            //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        columns = policy.nodes.empty() ? N : int(policy.nodes.size());              //@@@                                   ---
+        header.N = columns; header.nodes = N;                                       //@@@                                   ---
+        header.layer = Layer; header.format = Format;                               //@@@                                   ---
+        header.stride = policy.stride; header.first_step = policy.first_step;       //@@@                                   ---
+        header.dt = dt; header.coupling = Coupling;                                 //@@@                                   ---
+        header.scale = Format == Trajectory_int16 ? Trajectory_int16_scale : 1.0;   //@@@                                   ---
+        if (!policy.nodes.empty()) selected.resize(columns);                        //@@@                                   ---
+        if (policy.keep_last > 0){                                                  //@@@                                   ---
+            ring.resize(size_t(policy.keep_last)*columns);                          //@@@                                   ---
+            ring_steps.resize(policy.keep_last);                                    //@@@                                   ---
+            ring_times.resize(policy.keep_last);                                    //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (Format == Trajectory_text){                                             //@@@                                   ---
+            file.open(Filename + ".txt");                                           //@@@                                   ---
+            return;                                                                 //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        file.open(Filename + ".bin", ios::binary);                                  //@@@                                   ---
+        frame.resize(size_t(columns)*(Format == Trajectory_float64 ? 8 :            //@@@                                   ---
+                                      Format == Trajectory_float32 ? 4 : 2));       //@@@                                   ---
+        file.write(reinterpret_cast<const char*>(&header),sizeof(header));          //@@@                                   ---
+        for (int node : policy.nodes){                                              //@@@                                   ---
+            const uint32_t index = node;                                            //@@@                                   ---
+            file.write(reinterpret_cast<const char*>(&index),sizeof(index));        //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    ~Trajectory_writer() { close(); }                                               //@@@                                   ---
+    void write(long step,double time,const double* phi)                             //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (!policy.wanted(step)) return;                                           //@@@                                   ---
+        if (!policy.nodes.empty()){                                                 //@@@                                   ---
+            for (int c = 0; c < columns; c++) selected[c] = phi[policy.nodes[c]];   //@@@                                   ---
+            phi = selected.data();                                                  //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (policy.keep_last > 0){                                                  //@@@ overwrite the oldest frame        ---
+            const size_t k = size_t(kept % policy.keep_last);                       //@@@                                   ---
+            copy(phi,phi+columns,ring.begin()+k*columns);                           //@@@                                   ---
+            ring_steps[k] = step; ring_times[k] = time;                             //@@@                                   ---
+            kept++;                                                                 //@@@                                   ---
+            return;                                                                 //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        emit(time,phi);                                                             //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    void close()                                                                    //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (!file.is_open()) return;                                                //@@@                                   ---
+        if (policy.keep_last > 0){                                                  //@@@ the final frames, oldest first    ---
+            const long n = min(kept,policy.keep_last);                              //@@@                                   ---
+            for (long f = kept-n; f < kept; f++){                                   //@@@                                   ---
+                const size_t k = size_t(f % policy.keep_last);                      //@@@                                   ---
+                if (f == kept-n) header.first_step = ring_steps[k];                 //@@@                                   ---
+                emit(ring_times[k],&ring[k*columns]);                               //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            kept = 0;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (header.format != Trajectory_text){                                      //@@@ first step and frame count into   ---
+            file.seekp(0);                                                          //@@@ the header                        ---
+            file.write(reinterpret_cast<const char*>(&header),sizeof(header));      //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        file.close();                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+private:                                                                            //@@@                                   ---
+    void emit(double time,const double* phi)                                        //@@@ one frame to the file             ---
+    {                                                                               //@@@                                   ---
+        header.frames++;                                                            //@@@                                   ---
+        if (header.format == Trajectory_text){                                      //@@@ as the old text files, but no     ---
+            file << time << '\t';                                                   //@@@ flush per line                    ---
+            for (int i = 0; i < columns; i++)                                       //@@@                                   ---
+                file << std::fixed << std::setprecision(2) << phi[i] << '\t';       //@@@                                   ---
+            file << '\n';                                                           //@@@                                   ---
+            return;                                                                 //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (header.format == Trajectory_float64){                                   //@@@                                   ---
+            file.write(reinterpret_cast<const char*>(phi),frame.size());            //@@@                                   ---
+            return;                                                                 //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (header.format == Trajectory_float32){                                   //@@@                                   ---
+            float* out = reinterpret_cast<float*>(frame.data());                    //@@@                                   ---
+            for (int i = 0; i < columns; i++) out[i] = float(phi[i]);               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        else{                                                                       //@@@                                   ---
+            int16_t* out = reinterpret_cast<int16_t*>(frame.data());                //@@@ phases are in -pi..pi after       ---
+            for (int i = 0; i < columns; i++)                                       //@@@ check_scale; clamp anyway         ---
+                out[i] = int16_t(lround(min(max(phi[i]*header.scale,-32767.0),      //@@@                                   ---
+                                            32767.0)));                             //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        file.write(frame.data(),frame.size());                                      //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    ofstream file;                                                                  //@@@                                   ---
+    Trajectory_header header;                                                       //@@@                                   ---
+    Recording_policy policy;                                                        //@@@                                   ---
+    int columns = 0;                                                                //@@@ recorded nodes                    ---
+    vector<char> frame;                                                             //@@@ one converted step                ---
+    vector<double> selected;                                                        //@@@ the recorded nodes of one step    ---
+    vector<double> ring, ring_times;                                                //@@@ keep_last frames                  ---
+    vector<long> ring_steps;                                                        //@@@                                   ---
+    long kept = 0;                                                                  //@@@ frames seen in keep_last mode     ---
+};                                                                                  //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                               running statistics                               @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+double student_t_quantile(double p,double df)                                       //@@@ t with P(T<t)=p, p>0.5: exact for ---
+{                                                                                   //@@@ df 1 and 2, else Cornish-Fisher   ---
+    if (df <= 1.0) return tan(Pi*(p-0.5));                                          //@@@ around the normal quantile (error ---
+    if (df <= 2.0) return (2.0*p-1.0)/sqrt(2.0*p*(1.0-p));                          //@@@ below 1e-3 from df 4 on)          ---
+    const double q = 1.0-p, w = sqrt(-2.0*log(q));                                  //@@@ normal quantile, Abramowitz and   ---
+    const double z = w-(2.515517+0.802853*w+0.010328*w*w)/                          //@@@ Stegun 26.2.23, refined by two    ---
+                       (1.0+1.432788*w+0.189269*w*w+0.001308*w*w*w);                //@@@ Newton steps on erfc              ---
+    double x = z;                                                                   //@@@                                   ---
+    for (int k = 0; k < 2; k++)                                                     //@@@                                   ---
+        x += (0.5*erfc(x/sqrt(2.0))-q)*sqrt(2.0*Pi)*exp(0.5*x*x);                   //@@@                                   ---
+    const double x2 = x*x;                                                          //@@@                                   ---
+    return x + x*(x2+1.0)/(4.0*df)                                                  //@@@                                   ---
+             + x*((5.0*x2+16.0)*x2+3.0)/(96.0*df*df)                                //@@@                                   ---
+             + x*(((3.0*x2+19.0)*x2+17.0)*x2-15.0)/(384.0*df*df*df)                 //@@@                                   ---
+             + x*((((79.0*x2+776.0)*x2+1482.0)*x2-1920.0)*x2-945.0)                 //@@@                                   ---
+                 /(92160.0*df*df*df*df);                                            //@@@                                   ---
+}                                                                                   //@@@                                   ---
+struct Running_stats                                                                //@@@ Welford: mean and spread of r(t)  ---
+{                                                                                   //@@@ in one pass, nothing stored       ---
+    long n = 0;                                                                     //@@@                                   ---
+    double mean = 0.0, M2 = 0.0, min = 0.0, max = 0.0;                              //@@@                                   ---
+    void reset() { *this = Running_stats(); }                                       //@@@                                   ---
+    void add(double x){                                                             //@@@                                   ---
+        n++;                                                                        //@@@                                   ---
+        const double delta = x-mean;                                                //@@@                                   ---
+        mean += delta/n;                                                            //@@@                                   ---
+        M2 += delta*(x-mean);                                                       //@@@                                   ---
+        if (n == 1 || x < min) min = x;                                             //@@@                                   ---
+        if (n == 1 || x > max) max = x;                                             //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double std() const { return n > 1 ? sqrt(M2/(n-1)) : 0.0; }                     //@@@ sample std (ddof=1)               ---
+    double sem() const { return n > 1 ? std()/sqrt(double(n)) : 0.0; }              //@@@                                   ---
+    double ci_half_width(double confidence = 0.95) const {                          //@@@ two-sided, t with n-1 degrees     ---
+        return n > 1 ? student_t_quantile(0.5*(1.0+confidence),n-1)*sem() : 0.0;    //@@@ of freedom                        ---
+    }                                                                               //@@@                                   ---
+};                                                                                  //@@@                                   ---
+void write_stats_header(ofstream& file)                                             //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    file << "coupling\tlayer\tsteps\tsamples\tmean\tstd\tsem"                       //@@@                                   ---
+         << "\tci_low\tci_high\tmin\tmax" << endl;                                  //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void write_stats_row(ofstream& file,const string& coupling,int layer,int steps,     //@@@ one row per coupling and layer    ---
+                     const Running_stats& s)                                        //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    const double h = s.ci_half_width();                                             //@@@                                   ---
+    file << coupling << '\t' << layer << '\t' << steps << '\t' << s.n << '\t'       //@@@                                   ---
+         << s.mean << '\t' << s.std() << '\t' << s.sem() << '\t'                    //@@@                                   ---
+         << s.mean-h << '\t' << s.mean+h << '\t' << s.min << '\t' << s.max << endl; //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                              asynchronous output                               @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+const int Output_ring_slots = 64;                                                   //@@@ preallocated step slots           ---
+class Async_output                                                                  //@@@ the time loop fills a slot a step ---
+{                                                                                   //@@@ and hands it to a writer thread   ---
+public:                                                                             //@@@ (single producer/single consumer  ---
+    typedef function<void(long,double,const double*)> Sink;                         //@@@ ring), so formatting and write    ---
+    Async_output(size_t Payload,Sink Write,int Slots = Output_ring_slots)           //@@@ calls overlap with the RK4 steps  ---
+        : payload(Payload), slots(size_t(Slots)), buffer(size_t(Slots)*Payload),    //@@@ Sink(step,time,slot)              ---
+          steps(Slots), times(Slots), write(Write)                                  //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        writer = thread([this]{ run(); });                                          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    ~Async_output() { finish(); }                                                   //@@@                                   ---
+    Async_output(const Async_output&) = delete;                                     //@@@                                   ---
+    Async_output& operator=(const Async_output&) = delete;                          //@@@                                   ---
+    double* acquire()                                                               //@@@ producer: next free slot, waits   ---
+    {                                                                               //@@@ only while the ring is full       ---
+        const size_t h = head.load(memory_order_relaxed);                           //@@@                                   ---
+        if (h - tail.load(memory_order_acquire) == slots){                          //@@@                                   ---
+            backpressure++;                                                         //@@@                                   ---
+            while (h - tail.load(memory_order_acquire) == slots)                    //@@@                                   ---
+                this_thread::yield();                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        return &buffer[(h % slots)*payload];                                        //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    void publish(long Step,double Time)                                             //@@@ producer: queue the acquired slot ---
+    {                                                                               //@@@                                   ---
+        const size_t h = head.load(memory_order_relaxed);                           //@@@                                   ---
+        steps[h % slots] = Step;                                                    //@@@                                   ---
+        times[h % slots] = Time;                                                    //@@@                                   ---
+        head.store(h+1,memory_order_release);                                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    void finish()                                                                   //@@@ write out the queue, stop the     ---
+    {                                                                               //@@@ writer thread                     ---
+        if (!writer.joinable()) return;                                             //@@@                                   ---
+        done.store(true,memory_order_release);                                      //@@@                                   ---
+        writer.join();                                                              //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    long backpressure = 0;                                                          //@@@ steps that found the ring full    ---
+private:                                                                            //@@@                                   ---
+    void run()                                                                      //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        size_t t = tail.load(memory_order_relaxed);                                 //@@@                                   ---
+        int idle = 0;                                                               //@@@                                   ---
+        for (;;){                                                                   //@@@                                   ---
+            const size_t h = head.load(memory_order_acquire);                       //@@@                                   ---
+            if (t == h){                                                            //@@@                                   ---
+                if (done.load(memory_order_acquire) &&                              //@@@                                   ---
+                    t == head.load(memory_order_acquire)) return;                   //@@@                                   ---
+                if (++idle < 64) this_thread::yield();                              //@@@ idle writer gives its core back   ---
+                else this_thread::sleep_for(chrono::microseconds(50));              //@@@                                   ---
+                continue;                                                           //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            idle = 0;                                                               //@@@                                   ---
+            for (; t != h; t++){                                                    //@@@                                   ---
+                const size_t k = t % slots;                                         //@@@                                   ---
+                write(steps[k],times[k],&buffer[k*payload]);                        //@@@                                   ---
+                tail.store(t+1,memory_order_release);                               //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    size_t payload, slots;                                                          //@@@                                   ---
+    vector<double> buffer;                                                          //@@@                                   ---
+    vector<long> steps;                                                             //@@@                                   ---
+    vector<double> times;                                                           //@@@                                   ---
+    Sink write;                                                                     //@@@                                   ---
+    alignas(64) atomic<size_t> head{0};                                             //@@@ written by the producer only      ---
+    alignas(64) atomic<size_t> tail{0};                                             //@@@ written by the writer only        ---
+    atomic<bool> done{false};                                                       //@@@                                   ---
+    thread writer;                                                                  //@@@                                   ---
+};                                                                                  //@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 //@@@                                  previous phases                               @@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 double* for_loop_equal(double* Phase) {                                             //@@@calculate initial theta            ---
     return Phase;                                                                   //@@@                                   ---
 }                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                                fast text loader                                @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+class Mapped_file                                                                   //@@@ a whole file, read only: mmap on  ---
+{                                                                                   //@@@ Linux, else read into memory      ---
+public:                                                                             //@@@                                   ---
+    Mapped_file() = default;                                                        //@@@                                   ---
+    ~Mapped_file() { release(); }                                                   //@@@                                   ---
+    Mapped_file(const Mapped_file&) = delete;                                       //@@@                                   ---
+    Mapped_file& operator=(const Mapped_file&) = delete;                            //@@@                                   ---
+    bool open(const string& path)                                                   //@@@ false: not there (or empty)       ---
+    {                                                                               //@@@                                   ---
+        release();                                                                  //@@@                                   ---
+#ifdef __linux__                                                                    //@@@                                   ---
+        const int fd = ::open(path.c_str(),O_RDONLY);                               //@@@                                   ---
+        if (fd < 0) return false;                                                   //@@@                                   ---
+        struct stat st;                                                             //@@@                                   ---
+        if (fstat(fd,&st) == 0 && st.st_size > 0){                                  //@@@                                   ---
+            void* p = mmap(nullptr,size_t(st.st_size),PROT_READ,MAP_PRIVATE,fd,0);  //@@@                                   ---
+            if (p != MAP_FAILED){                                                   //@@@                                   ---
+                p_ = static_cast<const char*>(p);                                   //@@@                                   ---
+                n_ = size_t(st.st_size);                                            //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        ::close(fd);                                                                //@@@                                   ---
+        return p_ != nullptr;                                                       //@@@                                   ---
+#else                                                                               //@@@                                   ---
+        ifstream file(path,ios::binary);                                            //@@@                                   ---
+        if (!file) return false;                                                    //@@@                                   ---
+        copy_.assign(istreambuf_iterator<char>(file),istreambuf_iterator<char>());  //@@@                                   ---
+        p_ = copy_.data(); n_ = copy_.size();                                       //@@@                                   ---
+        return n_ > 0;                                                              //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const char* data() const { return p_; }                                         //@@@                                   ---
+    size_t size() const { return n_; }                                              //@@@                                   ---
+private:                                                                            //@@@                                   ---
+    void release()                                                                  //@@@                                   ---
+    {                                                                               //@@@                                   ---
+#ifdef __linux__                                                                    //@@@                                   ---
+        if (p_) munmap(const_cast<char*>(p_),n_);                                   //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+        p_ = nullptr; n_ = 0;                                                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const char* p_ = nullptr;                                                       //@@@                                   ---
+    size_t n_ = 0;                                                                  //@@@                                   ---
+#ifndef __linux__                                                                   //@@@                                   ---
+    vector<char> copy_;                                                             //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+};                                                                                  //@@@                                   ---
+struct Number_cache_header                                                          //@@@ <file>.txt.cache beside the input ---
+{                                                                                   //@@@ valid while the .txt has its size ---
+    char magic[4] = {'K','N','U','M'};                                              //@@@ and mtime and the numbers match   ---
+    uint32_t version = 1;                                                           //@@@ the checksum                      ---
+    uint64_t count = 0, source_size = 0;                                            //@@@                                   ---
+    int64_t source_mtime = 0;                                                       //@@@ nanoseconds where available       ---
+    uint64_t checksum = 0;                                                          //@@@                                   ---
+};                                                                                  //@@@                                   ---
+const int Checksum_blocks = 64;                                                     //@@@ fixed, so the sum does not depend ---
+uint64_t number_checksum(const double* x,size_t n)                                  //@@@ on the thread count               ---
+{                                                                                   //@@@                                   ---
+    uint64_t part[Checksum_blocks];                                                 //@@@ FNV-1a over 64-bit words per      ---
+    #pragma omp parallel for schedule(static)                                       //@@@ block, then over the blocks       ---
+    for (int k = 0; k < Checksum_blocks; k++){                                      //@@@                                   ---
+        uint64_t h = 14695981039346656037ULL;                                       //@@@                                   ---
+        const size_t first = n*k/Checksum_blocks, last = n*(k+1)/Checksum_blocks;   //@@@                                   ---
+        for (size_t t = first; t < last; t++){                                      //@@@                                   ---
+            uint64_t w;                                                             //@@@                                   ---
+            memcpy(&w,x+t,sizeof(w));                                               //@@@                                   ---
+            h = (h^w)*1099511628211ULL;                                             //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        part[k] = h;                                                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    uint64_t h = 14695981039346656037ULL^n;                                         //@@@                                   ---
+    for (int k = 0; k < Checksum_blocks; k++) h = (h^part[k])*1099511628211ULL;     //@@@                                   ---
+    return h;                                                                       //@@@                                   ---
+}                                                                                   //@@@                                   ---
+inline bool is_blank(char c)                                                        //@@@                                   ---
+{                                                                                   //@@@                                   ---
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';             //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void parse_numbers(const char* p,const char* end,vector<double>& out)               //@@@ whitespace separated numbers,     ---
+{                                                                                   //@@@ anything else is skipped          ---
+    while (p < end){                                                                //@@@                                   ---
+        while (p < end && is_blank(*p)) p++;                                        //@@@                                   ---
+        if (p == end) break;                                                        //@@@                                   ---
+        if (*p == '+') p++;                                                         //@@@ from_chars has no leading '+'     ---
+        double value;                                                               //@@@                                   ---
+        const from_chars_result r = from_chars(p,end,value);                        //@@@                                   ---
+        if (r.ec == errc()) { out.push_back(value); p = r.ptr; }                    //@@@                                   ---
+        while (p < end && !is_blank(*p)) p++;                                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+class Number_file                                                                   //@@@ all numbers of a text input: from ---
+{                                                                                   //@@@ its cache when it is valid, else  ---
+public:                                                                             //@@@ mmap + from_chars in parallel     ---
+    bool load(const string& path)                                                   //@@@ chunks, and the cache is written  ---
+    {                                                                               //@@@ for the next run                  ---
+        struct stat st;                                                             //@@@                                   ---
+        if (stat(path.c_str(),&st) != 0) return false;                              //@@@                                   ---
+        Number_cache_header want;                                                   //@@@                                   ---
+        want.source_size = uint64_t(st.st_size);                                    //@@@                                   ---
+#ifdef __linux__                                                                    //@@@                                   ---
+        want.source_mtime = int64_t(st.st_mtim.tv_sec)*1000000000                   //@@@                                   ---
+                          + st.st_mtim.tv_nsec;                                     //@@@                                   ---
+#else                                                                               //@@@                                   ---
+        want.source_mtime = int64_t(st.st_mtime)*1000000000;                        //@@@                                   ---
+#endif                                                                              //@@@                                   ---
+        if (load_cache(path+".cache",want)) { cached = true; return true; }         //@@@                                   ---
+        Mapped_file text;                                                           //@@@                                   ---
+        if (!text.open(path)) return want.source_size == 0;                         //@@@ empty file: no numbers            ---
+        const int chunks = max(1,min(omp_get_max_threads()*4,int(text.size()>>16)));//@@@ 64 kB or more per chunk           ---
+        vector<size_t> bound(chunks+1);                                             //@@@                                   ---
+        for (int k = 0; k <= chunks; k++){                                          //@@@ chunk edges moved onto a blank,   ---
+            size_t b = text.size()*k/chunks;                                        //@@@ so no number is cut               ---
+            while (b < text.size() && !is_blank(text.data()[b])) b++;               //@@@                                   ---
+            bound[k] = k == 0 ? 0 : max(b,bound[k-1]);                              //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        vector<vector<double>> part(chunks);                                        //@@@                                   ---
+        #pragma omp parallel for schedule(dynamic)                                  //@@@                                   ---
+        for (int k = 0; k < chunks; k++)                                            //@@@                                   ---
+            parse_numbers(text.data()+bound[k],text.data()+bound[k+1],part[k]);     //@@@                                   ---
+        size_t n = 0;                                                               //@@@                                   ---
+        for (const auto& p : part) n += p.size();                                   //@@@                                   ---
+        values.resize(n);                                                           //@@@                                   ---
+        n = 0;                                                                      //@@@                                   ---
+        for (const auto& p : part){                                                 //@@@                                   ---
+            copy(p.begin(),p.end(),values.begin()+n);                               //@@@                                   ---
+            n += p.size();                                                          //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        p_ = values.data(); n_ = values.size();                                     //@@@                                   ---
+        want.count = n_;                                                            //@@@                                   ---
+        want.checksum = number_checksum(p_,n_);                                     //@@@                                   ---
+        write_cache(path+".cache",want);                                            //@@@                                   ---
+        return true;                                                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double at(size_t k) const { return k < n_ ? p_[k] : 0.0; }                      //@@@ missing numbers read as 0,        ---
+    const double* data() const { return p_; }                                       //@@@ as ifstream >> left them          ---
+    size_t size() const { return n_; }                                              //@@@                                   ---
+    bool cached = false;                                                            //@@@ true: read from the .cache        ---
+private:                                                                            //@@@                                   ---
+    bool load_cache(const string& path,const Number_cache_header& want)             //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (!map.open(path) || map.size() < sizeof(Number_cache_header))            //@@@                                   ---
+            return false;                                                           //@@@                                   ---
+        Number_cache_header h;                                                      //@@@                                   ---
+        memcpy(&h,map.data(),sizeof(h));                                            //@@@                                   ---
+        if (memcmp(h.magic,want.magic,4) != 0 || h.version != want.version ||       //@@@                                   ---
+            h.source_size != want.source_size ||                                    //@@@                                   ---
+            h.source_mtime != want.source_mtime ||                                  //@@@                                   ---
+            map.size() != sizeof(h)+h.count*sizeof(double)) return false;           //@@@                                   ---
+        p_ = reinterpret_cast<const double*>(map.data()+sizeof(h));                 //@@@ the header keeps the doubles      ---
+        n_ = h.count;                                                               //@@@ 8-byte aligned                    ---
+        if (number_checksum(p_,n_) == h.checksum) return true;                      //@@@                                   ---
+        p_ = nullptr; n_ = 0;                                                       //@@@                                   ---
+        return false;                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    void write_cache(const string& path,const Number_cache_header& h) const         //@@@ to a temporary, then renamed: a   ---
+    {                                                                               //@@@ crash never leaves half a cache   ---
+        ofstream file(path+".tmp",ios::binary);                                     //@@@ (a read-only folder just means    ---
+        if (!file) return;                                                          //@@@ no cache)                         ---
+        file.write(reinterpret_cast<const char*>(&h),sizeof(h));                    //@@@                                   ---
+        file.write(reinterpret_cast<const char*>(p_),n_*sizeof(double));            //@@@                                   ---
+        file.close();                                                               //@@@                                   ---
+        if (!file || rename((path+".tmp").c_str(),path.c_str()) != 0)               //@@@                                   ---
+            remove((path+".tmp").c_str());                                          //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    Mapped_file map;                                                                //@@@                                   ---
+    vector<double> values;                                                          //@@@                                   ---
+    const double* p_ = nullptr;                                                     //@@@                                   ---
+    size_t n_ = 0;                                                                  //@@@                                   ---
+};                                                                                  //@@@                                   ---
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                                              |    |                                                     $$$$
 //                                                              |    |                                                     $$$$
@@ -273,13 +2003,11 @@ double* read_1D_L(string Filename, int Numberofnode)
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 //@@@                          Read matrix connection                               //@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
-double** read_2D_b(string Filename, int Numberofnode)                               //@@@                                   ---
+Matrix<double> read_2D_b(string Filename, int Numberofnode)                         //@@@                                   ---
 {                                                                                   //@@@                                   ---
-    double** data_2D = new double* [Numberofnode];                                  //@@@                                   ---
-    for (int i = 0; i < Numberofnode; i++)                                          //@@@                                   ---
-        data_2D[i] = new double[Numberofnode];                                      //@@@                                   ---
-    ifstream file("./Example/b=Intralayer frustration/" + Filename + ".txt");       //@@@                                   ---
-    if (!file)                                                                      //@@@                                   ---
+    Matrix<double> data_2D(Numberofnode,Numberofnode);                              //@@@                                   ---
+    Number_file numbers;                                                            //@@@ parsed once, cached for reuse     ---
+    if (!numbers.load("./Example/b=Intralayer frustration/" + Filename + ".txt"))   //@@@                                   ---
     {                                                                               //@@@                                   ---
         cout << "WARNING!\tb=Intralayer frustration matrix\t"<<Filename<<           //@@@                                   ---
         " file is not here!" << endl;                                               //@@@                                   ---
@@ -291,9 +2019,7 @@ double** read_2D_b(string Filename, int Numberofnode)
         {                                                                           //@@@                                   ---
             for (int j = 0; j < Numberofnode; j++)                                  //@@@                                   ---
             {                                                                       //@@@                                   ---
-                double elem = 0;                                                    //@@@                                   ---
-                file >> elem;                                                       //@@@                                   ---
-                data_2D[i][j] = elem;                                               //@@@                                   ---
+                data_2D[i][j] = numbers.at(size_t(i)*Numberofnode+j);               //@@@                                   ---
             }                                                                       //@@@                                   ---
         }                                                                           //@@@                                   ---
     }                                                                               //@@@                                   ---
@@ -304,13 +2030,11 @@ double** read_2D_b(string Filename, int Numberofnode)
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
 //@@@                          Read matrix connection                               //@@@                                   ---
 //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
-double** read_2D_A(string Filename, int Numberofnode)                               //@@@                                   ---
+Matrix<double> read_2D_A(string Filename, int Numberofnode)                         //@@@                                   ---
 {                                                                                   //@@@                                   ---
-    double** data_2D = new double* [Numberofnode];                                  //@@@                                   ---
-    for (int i = 0; i < Numberofnode; i++)                                          //@@@                                   ---
-        data_2D[i] = new double[Numberofnode];                                      //@@@                                   ---
-    ifstream file("./Example/A=Intralayeradjacencymatrix/" + Filename + ".txt");    //@@@                                   ---
-    if (!file)                                                                      //@@@                                   ---
+    Matrix<double> data_2D(Numberofnode,Numberofnode);                              //@@@                                   ---
+    Number_file numbers;                                                            //@@@ parsed once, cached for reuse     ---
+    if (!numbers.load("./Example/A=Intralayeradjacencymatrix/" + Filename + ".txt"))//@@@                                   ---
     {                                                                               //@@@                                   ---
         cout << "WARNING!\tA=Intralayer adjacency matrix\t"<<Filename<<             //@@@                                   ---
         " file is not here!" << endl;                                               //@@@                                   ---
@@ -322,9 +2046,7 @@ double** read_2D_A(string Filename, int Numberofnode)
         {                                                                           //@@@                                   ---
             for (int j = 0; j < Numberofnode; j++)                                  //@@@                                   ---
             {                                                                       //@@@                                   ---
-                double elem = 0;                                                    //@@@                                   ---
-                file >> elem;                                                       //@@@                                   ---
-                data_2D[i][j] = elem;                                               //@@@                                   ---
+                data_2D[i][j] = numbers.at(size_t(i)*Numberofnode+j);               //@@@                                   ---
             }                                                                       //@@@                                   ---
         }                                                                           //@@@                                   ---
     }                                                                               //@@@                                   ---
@@ -332,6 +2054,455 @@ double** read_2D_A(string Filename, int Numberofnode)
          data_2D[0][1]<< "\tLastst data="<< data_2D[0][Numberofnode-1] <<endl;      //@@@                                   ---
     return data_2D;                                                                 //@@@                                   ---
 }                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                            R=Random generators .txt                            @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+struct Random_stream                                                                //@@@ splitmix64: same numbers on every ---
+{                                                                                   //@@@ compiler and platform for a seed  ---
+    uint64_t state;                                                                 //@@@                                   ---
+    Random_stream(uint64_t seed,uint64_t stream) : state(seed) {                    //@@@ one stream per layer and kind:    ---
+        state = next() ^ (stream*0xD1B54A32D192ED03ULL);                            //@@@ changing one keeps the others     ---
+        next();                                                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    uint64_t next(){                                                                //@@@                                   ---
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);                              //@@@                                   ---
+        z = (z ^ (z >> 30))*0xBF58476D1CE4E5B9ULL;                                  //@@@                                   ---
+        z = (z ^ (z >> 27))*0x94D049BB133111EBULL;                                  //@@@                                   ---
+        return z ^ (z >> 31);                                                       //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double uniform(){ return (next() >> 11)*(1.0/9007199254740992.0); }             //@@@ [0,1)                             ---
+    double uniform(double a,double b){ return a+(b-a)*uniform(); }                  //@@@                                   ---
+    int below(int n){ return int(uniform()*n); }                                    //@@@ 0..n-1                            ---
+    double normal(double mean,double sd){                                           //@@@ Box-Muller, one value per call    ---
+        const double u1 = 1.0-uniform(), u2 = uniform();                            //@@@                                   ---
+        return mean+sd*sqrt(-2.0*log(u1))*cos(2.0*Pi*u2);                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    double lorentzian(double center,double gamma){                                  //@@@ Cauchy: x0+gamma*tan(pi(u-1/2))   ---
+        return center+gamma*tan(Pi*(uniform()-0.5));                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+};                                                                                  //@@@                                   ---
+struct Generator_spec                                                               //@@@ per layer; for an empty kind the  ---
+{                                                                                   //@@@ quantity is read from its file    ---
+    uint64_t seed = 0;                                                              //@@@ graph: er p | ba m | ws k beta |  ---
+    int layer = 0;                                                                  //@@@ all; frequency: uniform a b |     ---
+    string graph, frequency, phases;                                                //@@@ gaussian m sd | lorentzian x0 g | ---
+    vector<double> graph_p, frequency_p, phases_p;                                  //@@@ degree c; phases: uniform a b     ---
+};                                                                                  //@@@                                   ---
+Generator_spec read_1D_R(string Filename,int layer,uint64_t realisation = 0)        //@@@ lines "seed 42", "graph ba 3",    ---
+{                                                                                   //@@@ "frequency degree 1", ...         ---
+    Generator_spec spec;                                                            //@@@ ('#' starts a comment); the       ---
+    spec.layer = layer;                                                             //@@@ realisation is added to the seed  ---
+    ifstream file("./Example/R=Random generators/" + Filename + ".txt");            //@@@                                   ---
+    if (!file) return spec;                                                         //@@@ no file: every input from a file  ---
+    string line;                                                                    //@@@                                   ---
+    while (getline(file,line))                                                      //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        istringstream words(line.substr(0,line.find('#')));                         //@@@                                   ---
+        string key, kind;                                                           //@@@                                   ---
+        if (!(words >> key)) continue;                                              //@@@                                   ---
+        if (key == "seed") { words >> spec.seed; continue; }                        //@@@                                   ---
+        words >> kind;                                                              //@@@                                   ---
+        vector<double> p;                                                           //@@@                                   ---
+        for (double x; words >> x;) p.push_back(x);                                 //@@@                                   ---
+        if (key == "graph") { spec.graph = kind; spec.graph_p = p; }                //@@@                                   ---
+        else if (key == "frequency") {                                              //@@@                                   ---
+            spec.frequency = kind; spec.frequency_p = p;                            //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        else if (key == "phases") { spec.phases = kind; spec.phases_p = p; }        //@@@                                   ---
+        else cout << "WARNING!\tR=Random generators\t"<<Filename<<                  //@@@                                   ---
+             " line '" << line << "' is not understood" << endl;                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    spec.seed += realisation;                                                       //@@@                                   ---
+    cout << "R of "<<Filename + "\tloaded\t seed=" << spec.seed << "\tgraph=" <<    //@@@                                   ---
+    spec.graph << "\tfrequency=" << spec.frequency << "\tphases=" << spec.phases    //@@@                                   ---
+    << endl;                                                                        //@@@                                   ---
+    return spec;                                                                    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double parameter(const vector<double>& p,size_t k,double fallback)                  //@@@ k-th number of a spec line        ---
+{                                                                                   //@@@                                   ---
+    return k < p.size() ? p[k] : fallback;                                          //@@@                                   ---
+}                                                                                   //@@@                                   ---
+Sparse_adjacency undirected_CSR(int Numberofnode,                                   //@@@ both directions of every edge,    ---
+                                const vector<pair<int,int>>& edges)                 //@@@ each row sorted                   ---
+{                                                                                   //@@@                                   ---
+    Sparse_adjacency csr;                                                           //@@@                                   ---
+    csr.Number_of_node = Numberofnode;                                              //@@@                                   ---
+    csr.row_start.assign(Numberofnode+1,0);                                         //@@@                                   ---
+    for (const auto& e : edges){                                                    //@@@                                   ---
+        csr.row_start[e.first+1]++;                                                 //@@@                                   ---
+        csr.row_start[e.second+1]++;                                                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    for (int i = 0; i < Numberofnode; i++) csr.row_start[i+1] += csr.row_start[i];  //@@@                                   ---
+    csr.col.resize(csr.row_start[Numberofnode]);                                    //@@@                                   ---
+    vector<int> fill(csr.row_start.begin(),csr.row_start.end()-1);                  //@@@                                   ---
+    for (const auto& e : edges){                                                    //@@@                                   ---
+        csr.col[fill[e.first]++] = e.second;                                        //@@@                                   ---
+        csr.col[fill[e.second]++] = e.first;                                        //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    for (int i = 0; i < Numberofnode; i++)                                          //@@@                                   ---
+        sort(csr.col.begin()+csr.row_start[i],csr.col.begin()+csr.row_start[i+1]);  //@@@                                   ---
+    csr.Number_of_edge = int(csr.col.size());                                       //@@@                                   ---
+    return csr;                                                                     //@@@                                   ---
+}                                                                                   //@@@                                   ---
+Sparse_adjacency generate_graph(const Generator_spec& spec,int Numberofnode)        //@@@ undirected, no self loops, A_ij=1 ---
+{                                                                                   //@@@                                   ---
+    const int N = Numberofnode;                                                     //@@@                                   ---
+    Random_stream random(spec.seed,4*spec.layer+0);                                 //@@@                                   ---
+    vector<pair<int,int>> edges;                                                    //@@@                                   ---
+    const double p = spec.graph == "all" ? 1.0 : parameter(spec.graph_p,0,0.0);     //@@@                                   ---
+    if (spec.graph == "all" || (spec.graph == "er" && p >= 1))                      //@@@ complete graph                    ---
+    {                                                                               //@@@                                   ---
+        for (int i = 0; i < N; i++)                                                 //@@@                                   ---
+            for (int j = 0; j < i; j++) edges.push_back({i,j});                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    else if (spec.graph == "er")                                                    //@@@ G(N,p), geometric skips over the  ---
+    {                                                                               //@@@ pairs: O(N+E) (Batagelj-Brandes)  ---
+        const double log_q = log(1.0-p);                                            //@@@                                   ---
+        for (long v = 1, w = -1; p > 0 && v < N;){                                  //@@@                                   ---
+            w += 1+long(log(1.0-random.uniform())/log_q);                           //@@@                                   ---
+            while (w >= v && v < N) { w -= v; v++; }                                //@@@                                   ---
+            if (v < N) edges.push_back({int(v),int(w)});                            //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    else if (spec.graph == "ba")                                                    //@@@ preferential attachment: a star   ---
+    {                                                                               //@@@ of m+1 nodes, then every new node ---
+        const int m = max(1,min(N-1,int(parameter(spec.graph_p,0,1))));             //@@@ links to m distinct nodes drawn   ---
+        vector<int> ends;                                                           //@@@ in proportion to their degree     ---
+        for (int j = 1; j <= m; j++){                                               //@@@                                   ---
+            edges.push_back({j,0});                                                 //@@@                                   ---
+            ends.push_back(0); ends.push_back(j);                                   //@@@ every edge end once: drawing from ---
+        }                                                                           //@@@ it is drawing in proportion to k  ---
+        vector<int> targets;                                                        //@@@                                   ---
+        for (int i = m+1; i < N; i++){                                              //@@@                                   ---
+            targets.clear();                                                        //@@@                                   ---
+            while (int(targets.size()) < m){                                        //@@@                                   ---
+                const int t = ends[random.below(int(ends.size()))];                 //@@@                                   ---
+                if (find(targets.begin(),targets.end(),t) == targets.end())         //@@@                                   ---
+                    targets.push_back(t);                                           //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            for (int t : targets){                                                  //@@@                                   ---
+                edges.push_back({i,t});                                             //@@@                                   ---
+                ends.push_back(t); ends.push_back(i);                               //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    else if (spec.graph == "ws")                                                    //@@@ ring of k nearest neighbours,     ---
+    {                                                                               //@@@ each edge (i,i+j) rewired to a    ---
+        const int half = max(1,min((N-1)/2,int(parameter(spec.graph_p,0,2))/2));    //@@@ random new end with probability   ---
+        const double beta = parameter(spec.graph_p,1,0.0);                          //@@@ beta                              ---
+        vector<vector<int>> next(N);                                                //@@@ neighbours of each node           ---
+        auto linked = [&next](int i,int j){                                         //@@@                                   ---
+            return find(next[i].begin(),next[i].end(),j) != next[i].end(); };       //@@@                                   ---
+        auto drop = [](vector<int>& v,int x){ v.erase(find(v.begin(),v.end(),x)); };//@@@                                   ---
+        for (int j = 1; j <= half; j++)                                             //@@@                                   ---
+            for (int i = 0; i < N; i++){                                            //@@@                                   ---
+                next[i].push_back((i+j)%N);                                         //@@@                                   ---
+                next[(i+j)%N].push_back(i);                                         //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        for (int j = 1; j <= half; j++)                                             //@@@                                   ---
+            for (int i = 0; i < N; i++){                                            //@@@                                   ---
+                const int old_end = (i+j)%N;                                        //@@@                                   ---
+                if (random.uniform() >= beta || int(next[i].size()) >= N-1 ||       //@@@ full row: nothing to move to      ---
+                    !linked(i,old_end)) continue;                                   //@@@                                   ---
+                int w = random.below(N);                                            //@@@                                   ---
+                while (w == i || linked(i,w)) w = random.below(N);                  //@@@ no self loop, no double edge      ---
+                drop(next[i],old_end); drop(next[old_end],i);                       //@@@                                   ---
+                next[i].push_back(w); next[w].push_back(i);                         //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        for (int i = 0; i < N; i++)                                                 //@@@                                   ---
+            for (int j : next[i]) if (j < i) edges.push_back({i,j});                //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    else cout << "WARNING!\tgraph " << spec.graph << " is not known, no edges"      //@@@                                   ---
+              << endl;                                                              //@@@                                   ---
+    return undirected_CSR(N,edges);                                                 //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double* generate_frequencies(const Generator_spec& spec,const Sparse_adjacency& A)  //@@@ degree: w_i = c*k_i (first-order  ---
+{                                                                                   //@@@ transition), k_i from row_start,  ---
+    const int N = A.Number_of_node;                                                 //@@@ so any A works, read or generated ---
+    const vector<double>& p = spec.frequency_p;                                     //@@@                                   ---
+    double* data_1D = new double[N];                                                //@@@                                   ---
+    Random_stream random(spec.seed,4*spec.layer+1);                                 //@@@                                   ---
+    for (int i = 0; i < N; i++){                                                    //@@@                                   ---
+        if (spec.frequency == "degree")                                             //@@@                                   ---
+            data_1D[i] = parameter(p,0,1.0)*(A.row_start[i+1]-A.row_start[i]);      //@@@                                   ---
+        else if (spec.frequency == "gaussian")                                      //@@@                                   ---
+            data_1D[i] = random.normal(parameter(p,0,0.0),parameter(p,1,1.0));      //@@@                                   ---
+        else if (spec.frequency == "lorentzian")                                    //@@@                                   ---
+            data_1D[i] = random.lorentzian(parameter(p,0,0.0),parameter(p,1,1.0));  //@@@                                   ---
+        else                                                                        //@@@ uniform a b (default -1..1)       ---
+            data_1D[i] = random.uniform(parameter(p,0,-1.0),parameter(p,1,1.0));    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    cout << "W of Layer" << spec.layer << "\tgenerated (" << spec.frequency <<      //@@@                                   ---
+    ")\t First data=" << data_1D[0] << "\tLastst data=" << data_1D[N-1] << endl;    //@@@                                   ---
+    return data_1D;                                                                 //@@@                                   ---
+}                                                                                   //@@@                                   ---
+double* generate_phases(const Generator_spec& spec,int Numberofnode)                //@@@ uniform a b, default 0..2pi as    ---
+{                                                                                   //@@@ in the Initial_values notebooks   ---
+    double* data_1D = new double[Numberofnode];                                     //@@@                                   ---
+    Random_stream random(spec.seed,4*spec.layer+2);                                 //@@@                                   ---
+    const double a = parameter(spec.phases_p,0,0.0);                                //@@@                                   ---
+    const double b = parameter(spec.phases_p,1,2.0*Pi);                             //@@@                                   ---
+    for (int i = 0; i < Numberofnode; i++) data_1D[i] = random.uniform(a,b);        //@@@                                   ---
+    cout << "I of Layer" << spec.layer << "\tgenerated (" << spec.phases <<         //@@@                                   ---
+    ")\t First data=" << data_1D[0] << "\tLastst data=" <<                          //@@@                                   ---
+    data_1D[Numberofnode-1] << endl;                                                //@@@                                   ---
+    return data_1D;                                                                 //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                            edge list and binary CSR                            @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+struct CSR_file_header                                                              //@@@ <name>.csr: this header, then     ---
+{                                                                                   //@@@ int32 row_start[N+1], int32       ---
+    char magic[4] = {'K','C','S','R'};                                              //@@@ col[E], double weight[E] if       ---
+    uint32_t version = 1;                                                           //@@@ flags&1, double frustration[E]    ---
+    uint32_t N = 0, flags = 0;                                                      //@@@ if flags&2 (host byte order)      ---
+    uint64_t E = 0;                                                                 //@@@                                   ---
+};                                                                                  //@@@                                   ---
+bool read_binary_CSR(const string& path,int Numberofnode,Sparse_adjacency& csr)     //@@@ false: not there or not valid     ---
+{                                                                                   //@@@                                   ---
+    Mapped_file file;                                                               //@@@                                   ---
+    if (!file.open(path)) return false;                                             //@@@                                   ---
+    CSR_file_header h;                                                              //@@@                                   ---
+    if (file.size() < sizeof(h)) return false;                                      //@@@                                   ---
+    memcpy(&h,file.data(),sizeof(h));                                               //@@@                                   ---
+    const size_t N = h.N, E = h.E;                                                  //@@@                                   ---
+    const size_t bytes = sizeof(h)+4*(N+1)+4*E+((h.flags&1) ? 8*E : 0)              //@@@                                   ---
+                       + ((h.flags&2) ? 8*E : 0);                                   //@@@                                   ---
+    if (memcmp(h.magic,CSR_file_header().magic,4) != 0 || h.version != 1 ||         //@@@                                   ---
+        int(N) != Numberofnode || file.size() != bytes)                             //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        cout << "WARNING!\t" << path << " is not a CSR file of " << Numberofnode    //@@@                                   ---
+             << " nodes" << endl;                                                   //@@@                                   ---
+        return false;                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    const char* p = file.data()+sizeof(h);                                          //@@@                                   ---
+    auto take = [&p](auto& v,size_t n){                                             //@@@                                   ---
+        v.resize(n);                                                                //@@@                                   ---
+        memcpy(v.data(),p,n*sizeof(v[0]));                                          //@@@                                   ---
+        p += n*sizeof(v[0]);                                                        //@@@                                   ---
+    };                                                                              //@@@                                   ---
+    take(csr.row_start,N+1);                                                        //@@@                                   ---
+    take(csr.col,E);                                                                //@@@                                   ---
+    if (h.flags&1) take(csr.weight,E);                                              //@@@                                   ---
+    if (h.flags&2) take(csr.frustration,E);                                         //@@@                                   ---
+    bool broken = csr.row_start[0] != 0 || size_t(csr.row_start[N]) != E;           //@@@ the kernels index phi by col      ---
+    for (size_t i = 0; i < N && !broken; i++)                                       //@@@ unchecked: rows must not run      ---
+        broken = csr.row_start[i+1] < csr.row_start[i];                             //@@@ backwards, cols must be nodes     ---
+    for (size_t e = 0; e < E && !broken; e++)                                       //@@@                                   ---
+        broken = csr.col[e] < 0 || size_t(csr.col[e]) >= N;                         //@@@                                   ---
+    if (broken)                                                                     //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        cout << "WARNING!\t" << path << " has broken row starts or columns" << endl;//@@@                                   ---
+        csr.row_start.clear();                                                      //@@@ the next format starts from       ---
+        csr.col.clear();                                                            //@@@ an empty CSR                      ---
+        csr.weight.clear();                                                         //@@@                                   ---
+        csr.frustration.clear();                                                    //@@@                                   ---
+        return false;                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    return true;                                                                    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+void write_binary_CSR(const string& path,const Sparse_adjacency& csr)               //@@@ col must still be there (before   ---
+{                                                                                   //@@@ detect_all_to_all / pack_bits)    ---
+    CSR_file_header h;                                                              //@@@                                   ---
+    h.N = csr.Number_of_node; h.E = csr.col.size();                                 //@@@                                   ---
+    h.flags = (csr.weight.empty() ? 0 : 1) | (csr.frustration.empty() ? 0 : 2);     //@@@                                   ---
+    ofstream file(path,ios::binary);                                                //@@@                                   ---
+    auto put = [&file](const auto& v){                                              //@@@                                   ---
+        file.write(reinterpret_cast<const char*>(v.data()),v.size()*sizeof(v[0]));  //@@@                                   ---
+    };                                                                              //@@@                                   ---
+    file.write(reinterpret_cast<const char*>(&h),sizeof(h));                        //@@@                                   ---
+    put(csr.row_start); put(csr.col); put(csr.weight); put(csr.frustration);        //@@@                                   ---
+    cout << "CSR of " << path << "\twritten\t Edges=" << h.E << endl;               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+bool read_edge_list_CSR(const string& path,int Numberofnode,Sparse_adjacency& csr)  //@@@ one edge a line, i j [A_ij]       ---
+{                                                                                   //@@@ [b_ij], 1-based, '#' starts a     ---
+    Mapped_file text;                                                               //@@@ comment; a repeated edge keeps    ---
+    if (!text.open(path)) return false;                                             //@@@ its last line (b kept only if     ---
+    struct Edge { int i, j; double w, b; };                                         //@@@ some line has it)                 ---
+    vector<Edge> edges;                                                             //@@@                                   ---
+    bool frustration_given = false;                                                 //@@@                                   ---
+    const char* p = text.data();                                                    //@@@                                   ---
+    const char* end = p+text.size();                                                //@@@                                   ---
+    int line = 0;                                                                   //@@@                                   ---
+    while (p < end){                                                                //@@@                                   ---
+        const char* eol = find(p,end,'\n');                                         //@@@                                   ---
+        line++;                                                                     //@@@                                   ---
+        double x[4];                                                                //@@@                                   ---
+        int n = 0;                                                                  //@@@                                   ---
+        for (const char* q = p; n < 4;){                                            //@@@                                   ---
+            while (q < eol && (*q == ' ' || *q == '\t' || *q == '\r' || *q == ',')) //@@@                                   ---
+                q++;                                                                //@@@                                   ---
+            if (q == eol || *q == '#') break;                                       //@@@                                   ---
+            if (*q == '+') q++;                                                     //@@@                                   ---
+            const from_chars_result r = from_chars(q,eol,x[n]);                     //@@@                                   ---
+            if (r.ec != errc()) { n = -1; break; }                                  //@@@                                   ---
+            q = r.ptr; n++;                                                         //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        p = eol < end ? eol+1 : end;                                                //@@@                                   ---
+        if (n == 0) continue;                                                       //@@@ blank or comment line             ---
+        if (n < 2 || x[0] < 1 || x[0] > Numberofnode ||                             //@@@                                   ---
+            x[1] < 1 || x[1] > Numberofnode)                                        //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            cout << "WARNING!\t" << path << " line " << line                        //@@@                                   ---
+                 << " is not an edge and skipped" << endl;                          //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        if (n == 4) frustration_given = true;                                       //@@@                                   ---
+        edges.push_back({int(x[0])-1,int(x[1])-1,                                   //@@@                                   ---
+                         n >= 3 ? x[2] : 1.0,n == 4 ? x[3] : 0.0});                 //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    stable_sort(edges.begin(),edges.end(),[](const Edge& a,const Edge& b){          //@@@ row by row, the file order kept   ---
+        return a.i != b.i ? a.i < b.i : a.j < b.j; });                              //@@@ among repeats                     ---
+    csr.row_start.assign(Numberofnode+1,0);                                         //@@@                                   ---
+    csr.col.clear(); csr.weight.clear(); csr.frustration.clear();                   //@@@                                   ---
+    for (size_t e = 0; e < edges.size(); e++){                                      //@@@                                   ---
+        if (e+1 < edges.size() && edges[e+1].i == edges[e].i &&                     //@@@                                   ---
+            edges[e+1].j == edges[e].j) continue;                                   //@@@                                   ---
+        if (edges[e].w == 0) continue;                                              //@@@ A_ij=0 is no edge                 ---
+        csr.col.push_back(edges[e].j);                                              //@@@                                   ---
+        csr.weight.push_back(edges[e].w);                                           //@@@                                   ---
+        if (frustration_given) csr.frustration.push_back(edges[e].b);               //@@@                                   ---
+        csr.row_start[edges[e].i+1]++;                                              //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    for (int i = 0; i < Numberofnode; i++) csr.row_start[i+1] += csr.row_start[i];  //@@@                                   ---
+    return true;                                                                    //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                         Read matrix connection as CSR                          @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+Sparse_adjacency read_2D_CSR(string Filename_A,string Filename_b,int Numberofnode,  //@@@   A generated (R file), else from ---
+                             bool save_csr = false,                                 //@@@   <name>.csr, else <name>.edges,  ---
+                             const Generator_spec& generator = Generator_spec())    //@@@   else the N*N <name>.txt; b is a ---
+{                                                                                   //@@@   scalar, an N*N matrix or given  ---
+    Sparse_adjacency csr;                                                           //@@@   per edge                        ---
+    csr.Number_of_node = Numberofnode;                                              //@@@                                   ---
+    const string A = "./Example/A=Intralayeradjacencymatrix/" + Filename_A;         //@@@                                   ---
+    Number_file numbers_b;                                                          //@@@ parsed once, cached for reuse     ---
+    const bool file_b = numbers_b.load("./Example/b=Intralayer frustration/" +      //@@@                                   ---
+                                       Filename_b + ".txt");                        //@@@                                   ---
+    string format = "binary";                                                       //@@@                                   ---
+    if (!generator.graph.empty())                                                   //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        csr = generate_graph(generator,Numberofnode);                               //@@@ no text at all                    ---
+        format = "generated " + generator.graph;                                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    else if (!read_binary_CSR(A + ".csr",Numberofnode,csr))                         //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        format = "edge list";                                                       //@@@                                   ---
+        if (!read_edge_list_CSR(A + ".edges",Numberofnode,csr))                     //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            format = "matrix";                                                      //@@@                                   ---
+            Number_file numbers_A;                                                  //@@@                                   ---
+            if (!numbers_A.load(A + ".txt"))                                        //@@@                                   ---
+            {                                                                       //@@@                                   ---
+                cout << "WARNING!\tA=Intralayer adjacency matrix\t"<<Filename_A<<   //@@@                                   ---
+                " file is not here!" << endl;                                       //@@@                                   ---
+                return csr;                                                         //@@@                                   ---
+            }                                                                       //@@@                                   ---
+            csr.row_start.assign(Numberofnode+1,0);                                 //@@@                                   ---
+            for (int i = 0; i < Numberofnode; i++)                                  //@@@                                   ---
+            {                                                                       //@@@                                   ---
+                for (int j = 0; j < Numberofnode; j++)                              //@@@                                   ---
+                {                                                                   //@@@                                   ---
+                    const double elem = numbers_A.at(size_t(i)*Numberofnode+j);     //@@@                                   ---
+                    if (elem != 0){                                                 //@@@     keep only stored edges        ---
+                        csr.col.push_back(j);                                       //@@@                                   ---
+                        csr.weight.push_back(elem);                                 //@@@                                   ---
+                    }                                                               //@@@                                   ---
+                }                                                                   //@@@                                   ---
+                csr.row_start[i+1] = int(csr.col.size());                           //@@@                                   ---
+            }                                                                       //@@@                                   ---
+        }                                                                           //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    csr.Number_of_edge = int(csr.col.size());                                       //@@@                                   ---
+    if (csr.frustration.empty())                                                    //@@@ b from its own file: one value    ---
+    {                                                                               //@@@ for every edge, or A's pattern    ---
+        if (!file_b)                                                                //@@@ picked out of the N*N matrix      ---
+        {                                                                           //@@@                                   ---
+            cout << "WARNING!\tb=Intralayer frustration matrix\t"<<Filename_b<<     //@@@                                   ---
+            " file is not here! b=0 is used" << endl;                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        csr.frustration.assign(csr.Number_of_edge,0.0);                             //@@@                                   ---
+        for (int i = 0; i < Numberofnode && file_b; i++)                            //@@@                                   ---
+            for (int e = csr.row_start[i]; e < csr.row_start[i+1]; e++)             //@@@                                   ---
+                csr.frustration[e] = numbers_b.at(numbers_b.size() == 1 ? 0 :       //@@@                                   ---
+                                     size_t(i)*Numberofnode+csr.col[e]);            //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    if (csr.weight.empty()) csr.weight.assign(csr.Number_of_edge,1.0);              //@@@                                   ---
+    const bool weighted = any_of(csr.weight.begin(),csr.weight.end(),               //@@@                                   ---
+                                 [](double w){ return w != 1; });                   //@@@                                   ---
+    const bool frustrated = any_of(csr.frustration.begin(),csr.frustration.end(),   //@@@                                   ---
+                                   [](double b){ return b != 0; });                 //@@@                                   ---
+    if (!weighted) vector<double>().swap(csr.weight);                               //@@@     unweighted: drop weights      ---
+    if (!frustrated) vector<double>().swap(csr.frustration);                        //@@@     b=0: drop frustration         ---
+    if (save_csr && format != "binary") write_binary_CSR(A + ".csr",csr);           //@@@ --save-csr: used by the next run  ---
+    if (!detect_all_to_all(csr)) pack_bits(csr);                                    //@@@                                   ---
+    cout << "A of "<<Filename_A + "\tloaded as CSR (" << format << ")\t Edges="     //@@@                                   ---
+         << csr.Number_of_edge << "\tweighted=" << weighted                         //@@@                                   ---
+         << "\tfrustrated=" << frustrated << endl;                                  //@@@                                   ---
+    return csr;                                                                     //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                            E=Interlayer links .txt                             @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+void read_interlayer_links(string Filename,int Number_of_layer,int Numberofnode,    //@@@ one link per line, 1-based:       ---
+                           vector<Interlayer_link>& list)                           //@@@ layer node layer node L*B a       ---
+{                                                                                   //@@@ (target first, then source)       ---
+    ifstream file("./Example/E=Interlayer links/" + Filename + ".txt");             //@@@                                   ---
+    if (!file)                                                                      //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        cout << "WARNING!\tE=Interlayer links\t"<<Filename<<                        //@@@                                   ---
+        " file is not here!" << endl;                                               //@@@                                   ---
+        return;                                                                     //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    int target_layer, target_node, source_layer, source_node, line = 0, links = 0;  //@@@                                   ---
+    double weight, frust;                                                           //@@@                                   ---
+    while (file >> target_layer >> target_node >> source_layer >> source_node       //@@@                                   ---
+                >> weight >> frust)                                                 //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        line++;                                                                     //@@@                                   ---
+        if (target_layer < 1 || target_layer > Number_of_layer ||                   //@@@                                   ---
+            source_layer < 1 || source_layer > Number_of_layer ||                   //@@@                                   ---
+            target_node < 1 || target_node > Numberofnode ||                        //@@@                                   ---
+            source_node < 1 || source_node > Numberofnode)                          //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            cout << "WARNING!\tE=Interlayer links\t"<<Filename<<                    //@@@                                   ---
+            " line " << line << " is out of range and skipped" << endl;             //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        list.push_back({(target_layer-1)*Numberofnode+target_node-1,                //@@@                                   ---
+                        (source_layer-1)*Numberofnode+source_node-1,weight,frust}); //@@@                                   ---
+        links++;                                                                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    cout << "E of "<<Filename + "\tloaded\t Links=" << links << endl;               //@@@                                   ---
+}                                                                                   //@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+//@@@                             S=Recorded nodes .txt                              @@@@                                   ---
+//@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                   ---
+vector<int> read_1D_S(string Filename,int Numberofnode)                             //@@@ nodes written to the phase files, ---
+{                                                                                   //@@@ 1-based, any order; missing file  ---
+    vector<int> nodes;                                                              //@@@ = every node                      ---
+    ifstream file("./Example/S=Recorded nodes/" + Filename + ".txt");               //@@@                                   ---
+    if (!file)                                                                      //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        cout << "S of "<<Filename << "\tnot here, all nodes recorded" << endl;      //@@@                                   ---
+        return nodes;                                                               //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    int node;                                                                       //@@@                                   ---
+    while (file >> node)                                                            //@@@                                   ---
+    {                                                                               //@@@                                   ---
+        if (node < 1 || node > Numberofnode)                                        //@@@                                   ---
+        {                                                                           //@@@                                   ---
+            cout << "WARNING!\tS=Recorded nodes\t"<<Filename<<                      //@@@                                   ---
+            " node " << node << " is out of range and skipped" << endl;             //@@@                                   ---
+            continue;                                                               //@@@                                   ---
+        }                                                                           //@@@                                   ---
+        nodes.push_back(node-1);                                                    //@@@                                   ---
+    }                                                                               //@@@                                   ---
+    cout << "S of "<<Filename + "\tloaded\t Nodes=" << nodes.size() << endl;        //@@@                                   ---
+    return nodes;                                                                   //@@@                                   ---
+}                                                                                   //@@@                                   ---
+                                                                                    //@@@                                   ---
 //-----------------------------------------------------------------------------------------------------------------------------
 //                                                              |    |                                                     $$$$
 //                                                              |    |                                                     $$$$
@@ -383,6 +2554,7 @@ double* read_data(string name_of_file)
 {                                                                                   //@@@                                   ---
     int rows=count_rows_file(name_of_file);                                         //@@@                                   ---
     double* data = new double[rows+1];                                              //@@@                                   ---
+    data[0] = rows;                                                                 //@@@    data[0]= number of rows read   ---
     string kk;                                                                      //@@@                                   ---
     ifstream fp(name_of_file);                                                      //@@@                                   ---
     if (!fp)                                                                        //@@@                                   ---
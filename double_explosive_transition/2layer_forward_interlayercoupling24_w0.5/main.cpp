@@ -34,7 +34,18 @@
 //                                                                \/                                                       $$$$
 //                                           T1=W1+k/N*sum(A1*sin(I1+b1))+L12*B1*sin(I2+a1)                                $$$$
 //-----------------------------------------------------------------------------------------------------------------------------
-int main(){                                                                     //@@@           Beginning main              ---
+int main(int argc,char* argv[]){                                                //@@@           Beginning main              ---
+    if (argc > 1 && string(argv[1]) == "--simd-check"){                         //@@@  SIMD sin/cos: max ulp vs libm        ---
+        simd_diagnostics();                                                     //@@@  and Gsin/s for every path            ---
+        return 0;                                                               //@@@                                       ---
+    }                                                                           //@@@                                       ---
+    bool save_csr = false;                                                      //@@@ --save-csr: A also kept as <name>.csr ---
+    uint64_t realisation = 0;                                                   //@@@ --realisation r: R-file seeds + r  ---
+    for (int k = 1; k < argc; k++){                                             //@@@                                       ---
+        if (string(argv[k]) == "--save-csr") save_csr = true;                   //@@@                                       ---
+        if (string(argv[k]) == "--realisation" && k+1 < argc)                   //@@@                                       ---
+            realisation = stoull(argv[++k]);                                    //@@@                                       ---
+    }                                                                           //@@@                                       ---
     //-------------------------------------------------------------------------------------------------------------------------
     //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@    Read and definition data,          ---
     //@@@                                     data.txt and Example file          @@@@    Number_of_node,Phases_initial,     ---
@@ -42,20 +53,46 @@ int main(){
     const double* data=read_data("data.txt");                                   //@@@ read data from data.txt and write them---
     const int Number_of_node = int(data[1]);                                    //@@@        N=Number_of_node=1000          ---
     cout << "|------------------------------------------------------|\n"<< endl;//@@@                                       ---
-    const double* frequency_layer1 = read_1D_W("0.0Layer1",Number_of_node);     //@@@        w=natural frequency      L1    ---
-    const double* frequency_layer2 = read_1D_W("0.8Layer2",Number_of_node);     //@@@        w=natural frequency      L2    ---
-    double* Phases_initial_layer1 = read_1D_I("origin1",Number_of_node);        //@@@        I=initial Phases         L1    ---
-    double* Phases_initial_layer2 = read_1D_I("origin2",Number_of_node);        //@@@        I=initial Phases         L2    ---
-    const double* const* adj_layer1 = read_2D_A("Layer1",Number_of_node);       //@@@        A=adjacency matrix       L1    ---
-    const double* const* adj_layer2 = read_2D_A("Layer2",Number_of_node);       //@@@        A=adjacency matrix       L2    ---
+    const Generator_spec generator_layer1 = read_1D_R("Layer1",1,realisation);  //@@@ R=Random generators      L1           ---
+    const Generator_spec generator_layer2 = read_1D_R("Layer2",2,realisation);  //@@@ R=Random generators      L2           ---
+    Multiplex layers(2,Number_of_node);                                         //@@@ L1 and L2 in one M-layer engine       ---
+    layers.layer[0] = read_2D_CSR("Layer1","Layer1",                            //@@@ A=adjacency matrix       L1           ---
+                                  Number_of_node,save_csr,generator_layer1);    //@@@ b=Intralayer frustration L1           ---
+    layers.layer[1] = read_2D_CSR("Layer2","Layer2",                            //@@@ A=adjacency matrix       L2           ---
+                                  Number_of_node,save_csr,generator_layer2);    //@@@ b=Intralayer frustration L2           ---
+    const double* frequency_layer1 = generator_layer1.frequency.empty() ?       //@@@        w=natural frequency      L1    ---
+        read_1D_W("0.0Layer1",Number_of_node) :                                 //@@@                                       ---
+        generate_frequencies(generator_layer1,layers.layer[0]);                 //@@@ degree: after A                       ---
+    const double* frequency_layer2 = generator_layer2.frequency.empty() ?       //@@@        w=natural frequency      L2    ---
+        read_1D_W("0.8Layer2",Number_of_node) :                                 //@@@                                       ---
+        generate_frequencies(generator_layer2,layers.layer[1]);                 //@@@                                       ---
+    double* Phases_initial_layer1 = generator_layer1.phases.empty() ?           //@@@        I=initial Phases         L1    ---
+        read_1D_I("origin1",Number_of_node) :                                   //@@@                                       ---
+        generate_phases(generator_layer1,Number_of_node);                       //@@@                                       ---
+    double* Phases_initial_layer2 = generator_layer2.phases.empty() ?           //@@@        I=initial Phases         L2    ---
+        read_1D_I("origin2",Number_of_node) :                                   //@@@                                       ---
+        generate_phases(generator_layer2,Number_of_node);                       //@@@                                       ---
+    precompute_trig_weights(layers.layer[0]);                                   //@@@ A*cos(b) , A*sin(b)      L1           ---
+    precompute_trig_weights(layers.layer[1]);                                   //@@@ A*cos(b) , A*sin(b)      L2           ---
     const double* bdj_layer1 = read_1D_B("Layer1to2",Number_of_node);           //@@@        B=Interlayer connection  L1    ---
     const double* bdj_layer2 = read_1D_B("Layer2to1",Number_of_node);           //@@@        B=Interlayer connection  L2    ---
     const double* frust_layer1 = read_1D_a("Layer1to2",Number_of_node);         //@@@        a=Interlayer frustration L1    ---
     const double* frust_layer2 = read_1D_a("Layer2to1",Number_of_node);         //@@@        a=Interlayer frustration L2    ---
-    const double* const* Intrafrust_layer1 = read_2D_b("Layer1",Number_of_node);//@@@        b=Intralayer frustration L1    ---
-    const double* const* Intrafrust_layer2 = read_2D_b("Layer2",Number_of_node);//@@@        b=Intralayer frustration L2    ---
     const double* inter_layer1 = read_1D_L("Layer1to2",Number_of_node);         //@@@        L=Interlayer coupling    L1    ---
     const double* inter_layer2 = read_1D_L("Layer2to1",Number_of_node);         //@@@        L=Interlayer coupling    L2    ---
+    vector<Interlayer_link> links;                                              //@@@ L1 pulled by L2 and L2 by L1          ---
+    add_one_to_one_links(links,Number_of_node,0,1,                              //@@@ node to node: L*B*sin(I2-I1+a)        ---
+                         inter_layer1,bdj_layer1,frust_layer1);                 //@@@                                       ---
+    add_one_to_one_links(links,Number_of_node,1,0,                              //@@@                                       ---
+                         inter_layer2,bdj_layer2,frust_layer2);                 //@@@                                       ---
+    layers.links = make_interlayer_links(layers.size(),links);                  //@@@                                       ---
+    copy(frequency_layer1,frequency_layer1+Number_of_node,layers.W.begin());    //@@@ W and initial phases                  ---
+    copy(frequency_layer2,frequency_layer2+Number_of_node,                      //@@@ into the layer*N+i vectors            ---
+         layers.W.begin()+Number_of_node);                                      //@@@                                       ---
+    copy(Phases_initial_layer1,Phases_initial_layer1+Number_of_node,            //@@@                                       ---
+         layers.phases(0));                                                     //@@@                                       ---
+    copy(Phases_initial_layer2,Phases_initial_layer2+Number_of_node,            //@@@                                       ---
+         layers.phases(1));                                                     //@@@                                       ---
     cout << "|------------------------------------------------------|\n"<< endl;//@@@                                       ---
     //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                       ---
     //@@@                                definitions                             @@@@                                       ---
@@ -65,10 +102,19 @@ int main(){
     int coupling_step = round(data[5]/data[6]);                                 //@@@                                       ---
     ofstream Average_Syncrony(                                                  //@@@                                       ---
         "Save/Average_Syncrony(couplig_SyncL1_SyncL2_Extime)/output.txt");      //@@@       Create Sync file                ---
-    double* Phases_next_layer1 = new double[Number_of_node];                    //@@@    Definition Phases next             ---
-    double* Phases_next_layer2 = new double[Number_of_node];                    //@@@                                       ---
-    double* Phases_layer1_previous = for_loop_equal(Phases_initial_layer1);     //@@@               Phases changer          ---
-    double* Phases_layer2_previous = for_loop_equal(Phases_initial_layer2);     //@@@               [node][delay]           ---
+    ofstream Syncrony_stats(                                                    //@@@ mean, std, sem, 95% CI, min, max      ---
+        "Save/Syncrony_stats(couplig_layer_mean_std_sem_CI)/output.txt");       //@@@ of r per coupling and layer           ---
+    write_stats_header(Syncrony_stats);                                         //@@@                                       ---
+    Running_stats stats_layer1, stats_layer2;                                   //@@@ Welford over the averaged steps       ---
+    const int Number_of_threads = number_of_threads(                            //@@@    data[8]= threads (0 = all cores)   ---
+                                  data[0] >= 8 ? data[8] : 0);                  //@@@                                       ---
+    Steady_state steady_layer1(data[0] >= 9 ? data[9] : 0);                     //@@@ data[9]= steady-state tolerance       ---
+    Steady_state steady_layer2(data[0] >= 9 ? data[9] : 0);                     //@@@ (0 = whole time horizon)              ---
+    const int Trajectory_format = data[0] >= 10 ? int(data[10]) : 0;            //@@@ data[10]= phases file: 0 text,        ---
+    const Recording_policy record_layer1 = make_recording_policy(data,          //@@@ 1 float64, 2 float32, 3 int16         ---
+                                           read_1D_S("Layer1",Number_of_node)); //@@@ data[11..14]= window, stride,         ---
+    const Recording_policy record_layer2 = make_recording_policy(data,          //@@@ final T; S=Recorded nodes             ---
+                                           read_1D_S("Layer2",Number_of_node)); //@@@                                       ---
     //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
     //@@@                                      coupling loop                    //@@@                                       ---@
     //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                       ---@
@@ -78,84 +124,98 @@ int main(){
         ostringstream ostrcoupling;                                             //@@@    declaring output string stream     ---@
         ostrcoupling << fixed << setprecision(2) << coupling;                   //@@@  Sending a number as a stream output  ---@
         string strcoupling = ostrcoupling.str();                                //@@@ the str() converts number into string ---@
-        ofstream Phases_layer2("Save/Phases(time)VS(Node)/L2_k="+               //@@@       create file for phases L2       ---@
-                               strcoupling+"layer2.txt");                       //@@@                                       ---@
-        ofstream Phases_layer1("Save/Phases(time)VS(Node)/L1_k="+               //@@@       create file for phases L1       ---@
-                               strcoupling+"layer1.txt");                       //@@@                                       ---@
+        Trajectory_writer Phases_layer2("Save/Phases(time)VS(Node)/L2_k="+      //@@@       create file for phases L2       ---@
+                               strcoupling+"layer2",Trajectory_format,          //@@@  .txt, or .bin with a header          ---@
+                               Number_of_node,2,data[3],coupling,               //@@@                                       ---@
+                               record_layer2);                                  //@@@                                       ---@
+        Trajectory_writer Phases_layer1("Save/Phases(time)VS(Node)/L1_k="+      //@@@       create file for phases L1       ---@
+                               strcoupling+"layer1",Trajectory_format,          //@@@                                       ---@
+                               Number_of_node,1,data[3],coupling,               //@@@                                       ---@
+                               record_layer1);                                  //@@@                                       ---@
         double Total_syncrony_layer1 = 0;                                       //@@@          def tot synchroney L1        ---@
         double Total_syncrony_layer2 = 0;                                       //@@@          def tot synchroney L2        ---@
+        int steps_used = 0;                                                     //@@@ time steps integrated                 ---@
+        bool settled = false;                                                   //@@@ both layers settled: stop early       ---@
+        steady_layer1.reset();                                                  //@@@                                       ---@
+        steady_layer2.reset();                                                  //@@@                                       ---@
+        stats_layer1.reset();                                                   //@@@                                       ---@
+        stats_layer2.reset();                                                   //@@@                                       ---@
         //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
         //@@@                                        time loop                  //@@@                                       ---@  @
         //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                       ---@  @
         ofstream time_syncroney("Save/Syncrony(time_SyncL1_SyncL2)/k="+         //@@@                                       ---@  @
                                 strcoupling+".txt");                            //@@@                                       ---@  @
-        double time_step = double(data[2]);                                     //@@@     reset time for new time           ---@  @        
-        for (time_step;time_step < int(data[4]/data[3]);time_step++){           //@@@                                       ---@  @
+        const int Nodes = layers.size();                                        //@@@ slot: phases L1,L2 then r1,r2         ---@  @
+        Async_output output(Nodes+2,[&](long step,double Time,const double* x){ //@@@ written on the writer thread,         ---@  @
+            Phases_layer2.write(step,Time,x+Number_of_node);                    //@@@ the time loop only copies into        ---@  @
+            Phases_layer1.write(step,Time,x);                                   //@@@ a ring slot                           ---@  @
+            time_syncroney<<Time<< '\t'<<x[Nodes]<< '\t'<<x[Nodes+1]<<'\n';     //@@@   print synchrony data in file .txt   ---@  @
+        });                                                                     //@@@                                       ---@  @
+        #pragma omp parallel num_threads(Number_of_threads)                     //@@@  one team for the whole time loop     ---@  @
+        {                                                                       //@@@  kernels share out the nodes          ---@  @
+        double time_step = double(data[2]);                                     //@@@     reset time for new time           ---@  @
+        for (time_step;time_step < int(data[4]/data[3]);time_step++){           //@@@      (same clock on every thread)     ---@  @
             double time_loop=time_step*data[3];                                 //@@@                                       ---@  @
-            Runge_Kutta_4(Number_of_node,                                       //@@@   Runge-Kutta 4th Order Method  L1    ---@  @
-                        data[3],                                                //@@@                                       ---@  @
-                        coupling,                                               //@@@                                       ---@  @
-                        frequency_layer1,                                       //@@@                                       ---@  @
-                        inter_layer1,                                           //@@@                                       ---@  @
-                        bdj_layer1,                                             //@@@                                       ---@  @
-                        frust_layer1,                                           //@@@                                       ---@  @
-                        Intrafrust_layer1,                                      //@@@                                       ---@  @
-                        adj_layer1,                                             //@@@                                       ---@  @
-                        Phases_layer1_previous,                                 //@@@                                       ---@  @
-                        Phases_layer2_previous,                                 //@@@                                       ---@  @
-                        Phases_next_layer1);                                    //@@@                                       ---@  @
-            Runge_Kutta_4(Number_of_node,                                       //@@@   Runge-Kutta 4th Order Method  L2    ---@  @
-                        data[3],                                                //@@@                                       ---@  @
-                        coupling,                                               //@@@                                       ---@  @
-                        frequency_layer2,                                       //@@@                                       ---@  @
-                        inter_layer2,                                           //@@@                                       ---@  @
-                        bdj_layer2,                                             //@@@                                       ---@  @
-                        frust_layer2,                                           //@@@                                       ---@  @
-                        Intrafrust_layer2,                                      //@@@                                       ---@  @
-                        adj_layer2,                                             //@@@                                       ---@  @
-                        Phases_layer2_previous,                                 //@@@                                       ---@  @
-                        Phases_layer1_previous,                                 //@@@                                       ---@  @
-                        Phases_next_layer2);                                    //@@@                                       ---@  @
-            Phases_layer1_previous = for_loop_equal(Phases_next_layer1);        //@@@           Back to the future L1       ---@  @
-            Phases_layer2_previous = for_loop_equal(Phases_next_layer2);        //@@@           Back to the future L2       ---@  @
-            check_scale(Number_of_node,Phases_layer1_previous);                 //@@@       scale phases in -pi tp pi L1    ---@  @
-            check_scale(Number_of_node,Phases_layer2_previous);                 //@@@       scale phases in -pi tp pi L2    ---@  @
-            double syncrony_layer1 = order_parameter(Number_of_node,            //@@@                                       ---@  @
-                                    Phases_layer1_previous);                    //@@@     order parameters (Synchroney) L1  ---@  @
-            double syncrony_layer2 = order_parameter(Number_of_node,            //@@@                                       ---@  @
-                                    Phases_layer2_previous);                    //@@@     order parameters (Synchroney) L2  ---@  @
+            multiplex_step(layers,data[3],coupling);                            //@@@ RK4 L1, then L2 on the new L1         ---@  @
+            check_scale(layers.size(),layers.phase.data());                     //@@@ scale phases in -pi tp pi L1,L2       ---@  @
+            double syncrony_layer1 = multiplex_order_parameter(layers,0);       //@@@ order parameters (Synchroney) L1      ---@  @
+            double syncrony_layer2 = multiplex_order_parameter(layers,1);       //@@@ order parameters (Synchroney) L2      ---@  @
+            #pragma omp single                                                  //@@@      output from one thread           ---@  @
+            {                                                                   //@@@                                       ---@  @
             //------------------------------------------------------------------//@@@------------------------------------------@  @
-            Phases_layer2 << time_loop << '\t';                                 //@@@                                       ---@  @
-            Phases_layer1 << time_loop << '\t';                                 //@@@                                       ---@  @
-            for (int i = 0; i < Number_of_node; i++){                           //@@@                                       ---@  @
-                Phases_layer2 << std::fixed << std::setprecision(2) <<          //@@@                                       ---@  @
-                                            Phases_layer2_previous[i] << '\t';  //@@@--->  print phase data in file .txt    ---@  @
-                Phases_layer1 << std::fixed << std::setprecision(2) <<          //@@@                                       ---@  @
-                                            Phases_layer1_previous[i] << '\t';  //@@@                                       ---@  @
-            }                                                                   //@@@                                       ---@  @
-            Phases_layer2 << endl;                                              //@@@                                       ---@  @
-            Phases_layer1 << endl;                                              //@@@                                       ---@  @
+            double* slot = output.acquire();                                    //@@@--->  phases and r to the writer       ---@  @
+            if (record_layer1.wanted(long(time_step)) ||                        //@@@ phases only on recorded steps         ---@  @
+                record_layer2.wanted(long(time_step)))                          //@@@                                       ---@  @
+                copy(layers.phases(0),layers.phases(0)+Nodes,slot);             //@@@                                       ---@  @
+            slot[Nodes] = syncrony_layer1;                                      //@@@                                       ---@  @
+            slot[Nodes+1] = syncrony_layer2;                                    //@@@                                       ---@  @
+            output.publish(long(time_step),time_loop);                          //@@@                                       ---@  @
             //------------------------------------------------------------------//@@@------------------------------------------@  @
             if (time_step>=Number_Steps_time_stationary){                       //@@@                                       ---@  @
                 Total_syncrony_layer1 += syncrony_layer1;                       //@@@         calculate synchroney L1       ---@  @
                 Total_syncrony_layer2 += syncrony_layer2;                       //@@@         calculate synchroney L2       ---@  @
+                stats_layer1.add(syncrony_layer1);                              //@@@   mean,std,min,max on the fly         ---@  @
+                stats_layer2.add(syncrony_layer2);                              //@@@                                       ---@  @
             }                                                                   //@@@                                       ---@  @
-            time_syncroney<<time_loop<< '\t'<<syncrony_layer1<< '\t'            //@@@   print synchrony data in file .txt   ---@  @
-                          <<syncrony_layer2<<endl;                              //@@@                                       ---@  @
+            steps_used++;                                                       //@@@                                       ---@  @
+            const bool settled_layer1 = steady_layer1.add(syncrony_layer1);     //@@@                                       ---@  @
+            const bool settled_layer2 = steady_layer2.add(syncrony_layer2);     //@@@                                       ---@  @
+            settled = settled_layer1 && settled_layer2;                         //@@@                                       ---@  @
             //cout<<time_loop<< '\t'<<syncrony_layer1<< '\t'                    //@@@           cout synchrony data         ---@  @
                           //<<syncrony_layer2<<endl;                            //@@@                                       ---@  @
+            }                                                                   //@@@                                       ---@  @
+            if (settled) break;                                                 //@@@ flag read after the single's barrier  ---@  @
         }                                                                       //@@@                                       ---@  @
+        }                                                                       //@@@       end of parallel region          ---@  @
+        output.finish();                                                        //@@@ all written before the files close    ---@
         //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@
         Total_syncrony_layer1=Total_syncrony_layer1/                            //@@@                                       ---@
                               (Number_Steps_time_stationary*4);                 //@@@    calculate total sync and pint it   ---@
         Total_syncrony_layer2=Total_syncrony_layer2/                            //@@@                                       ---@
                               (Number_Steps_time_stationary*4);                 //@@@                                       ---@
+        if (settled){                                                           //@@@ stopped early: mean of the            ---@
+            Total_syncrony_layer1 = steady_layer1.mean;                         //@@@ settled segment, statistics           ---@
+            Total_syncrony_layer2 = steady_layer2.mean;                         //@@@ over the same samples                 ---@
+            stats_layer1.reset();                                               //@@@                                       ---@
+            stats_layer2.reset();                                               //@@@                                       ---@
+            for (size_t i = steady_layer1.r.size()/5;                           //@@@                                       ---@
+                 i < steady_layer1.r.size(); i++)                               //@@@                                       ---@
+                stats_layer1.add(steady_layer1.r[i]);                           //@@@                                       ---@
+            for (size_t i = steady_layer2.r.size()/5;                           //@@@                                       ---@
+                 i < steady_layer2.r.size(); i++)                               //@@@                                       ---@
+                stats_layer2.add(steady_layer2.r[i]);                           //@@@                                       ---@
+        }                                                                       //@@@                                       ---@
         time_t end = time(NULL);                                                //@@@             time of run               ---@
         cout<<"k=" <<strcoupling << '\t' <<"r="<< Total_syncrony_layer2 <<      //@@@       cout total synchrony data       ---@
-        '\t' <<"Ex Time: "<< (double)(end-start)<<" Sec"<<endl;                 //@@@                                       ---@
+        '\t' <<"Ex Time: "<< (double)(end-start)<<" Sec"<<                      //@@@                                       ---@
+        '\t' <<"Backpressure: "<< output.backpressure <<endl;                   //@@@ steps that waited for the writer      ---@
         Average_Syncrony << strcoupling << '\t' << Total_syncrony_layer1 <<     //@@@          print total synchrony        ---@
                          '\t' << Total_syncrony_layer2<< '\t' <<                //@@@            data in file .txt          ---@
-                         (double)(end-start) << endl;                           //@@@                                       ---@
+                         (double)(end-start);                                   //@@@                                       ---@
+        if (steady_layer1.enabled()) Average_Syncrony << '\t' << steps_used;    //@@@ steps actually integrated             ---@
+        Average_Syncrony << endl;                                               //@@@                                       ---@
+        write_stats_row(Syncrony_stats,strcoupling,1,steps_used,stats_layer1);  //@@@   print statistics of r               ---@
+        write_stats_row(Syncrony_stats,strcoupling,2,steps_used,stats_layer2);  //@@@                                       ---@
         Phases_layer2.close();                                                  //@@@                                       ---@
         Phases_layer1.close();                                                  //@@@                                       ---@
     }                                                                           //@@@                                       ---@
@@ -163,17 +223,21 @@ int main(){
     ofstream Last_Phase_layer1("Save/Last_Phase/layer1.txt");                   //@@@                                       ---
     ofstream Last_Phase_layer2("Save/Last_Phase/layer2.txt");                   //@@@                                       ---
     for (int i = 0; i < Number_of_node; i++){                                   //@@@                                       ---
-        Last_Phase_layer1 << Phases_layer1_previous[i] << endl;                 //@@@--->   print last coupling phases      ---
-        Last_Phase_layer2 << Phases_layer2_previous[i] << endl;                 //@@@                                       ---
+        Last_Phase_layer1 << layers.phases(0)[i] << endl;                       //@@@--->   print last coupling phases      ---
+        Last_Phase_layer2 << layers.phases(1)[i] << endl;                       //@@@                                       ---
     }                                                                           //@@@                                       ---
     //--------------------------------------------------------------------------//@@@------------------------------------------
     Average_Syncrony.close();                                                   //@@@                                       ---
+    Syncrony_stats.close();                                                     //@@@                                       ---
     Last_Phase_layer1.close();                                                  //@@@                                       ---
     Last_Phase_layer2.close();                                                  //@@@                                       ---
-    delete Phases_layer1_previous;                                              //@@@                                       ---
-    delete Phases_layer2_previous;                                              //@@@                                       ---
-    delete Phases_next_layer1;                                                  //@@@                                       ---
-    delete Phases_next_layer2;                                                  //@@@                                       ---
+    delete[] Phases_initial_layer1;                                             //@@@ copied into the engine                ---
+    delete[] Phases_initial_layer2;                                             //@@@                                       ---
+    delete[] frequency_layer1; delete[] frequency_layer2;                       //@@@     inputs read by the read_1D_*      ---
+    delete[] bdj_layer1; delete[] bdj_layer2;                                   //@@@                                       ---
+    delete[] frust_layer1; delete[] frust_layer2;                               //@@@                                       ---
+    delete[] inter_layer1; delete[] inter_layer2;                               //@@@                                       ---
+    delete[] data;                                                              //@@@                                       ---
     //@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@@                                       ---                                                                             //@@@@                                   ---
     return 0;                                                                   //@@@     dont return any thing             ---
 }                                                                               //@@@                                       ---
@@ -1,59 +1,342 @@
 // C++ Program to demonstrate Mathematical model (kuramoto single layer)
 #include"Kuramoto.Version4.h"//library Kuramoto version 4 (ubuntu version push in github)
 
-int main() {
-    // Hint1: count_rows_cols_file: para in address of file that is ./data.txt
-    // Hint2: read_data: first para is number of rows in data file and second para is boolean[0=dont show data,1=show data]
-    // data[0]=N & data[1]=L & data[2]=a
-    // data[3]=t_0 & data[4]=∆t & data[5]=t_f
-    // data[6]=k_0 & data[7]=∆k & data[8]=k_f
-    // data[9]=τ_0 & data[10]=∆τ & data[11]=τ_f
-    double* data=read_data(count_rows_cols_file("data.txt"),0);
-    double* frequency_layer1 = read_initial_1D("W=Natural frequency/w_mean2(0,4)", int(data[0]));
-    double* Phases_initial_layer1 = read_initial_1D("P=Initial Phases/theta", int(data[0]));//Initial Phases  P
-    int** adj_layer1 = read_initial_2D("A=Intralayer adjacency matrix/matrix_old", int(data[0]));//adjacency matrix  A
+// One coupling sweep of the single layer. The inputs are only read, so the runs of a job manifest
+// that name the same files share one copy
+int run_sweep(const Sweep_job& job, const double* frequency_layer1, const double* Phases_initial_layer1,
+              const Sparse_adjacency& adj_layer1, bool Heterogeneous_delay, bool resume) {
+    vector<double> rows = job.data;// the job's own data.txt
+    double* data = rows.data();
+    int Number_of_data = int(rows.size());
+    int Number_of_threads = number_of_threads(Number_of_data > 12 ? data[12] : 0);
+    error_code ignored;
+    for (string folder : {"Save/Avg_Sync/layer1", "Save/Sync_stats/layer1", "Save/Phases/layer1", "Save/Last_Phase/layer1"}) {
+        filesystem::create_directories(job.output + folder, ignored);
+    }
     double Delay_variable = data[9];
     // while (Delay_variable < (data[11])){Delay_variable+=data[10]} // Delay loop
     double* Phases_next_layer1 = new double[int(data[0])];
-    double** Phases_history_delay_layer1 = memory_of_delay_of_phases(int(data[0]),Delay_variable,data[4],Phases_initial_layer1);
-    double* Phases_layer1_previous = shift_pi2_phases(int(data[0]),Delay_variable,data[4], Phases_history_delay_layer1);//Phases changer
+    Trig_workspace trig_layer1 = Trig_workspace(int(data[0]), Heterogeneous_delay ? adj_layer1.Number_of_edge : 0);// sin/cos and neighbour sums, reused every step
+    Reduction_workspace order_layer1 = Reduction_workspace(int(data[0]));// block sums of the order parameter
+    Steady_state steady_layer1 = Steady_state(Number_of_data > 13 ? data[13] : 0);// early exit once r(t) has settled
+    Delay_history Phases_history_delay_layer1 = Heterogeneous_delay ? memory_of_delay_of_phases(adj_layer1, Phases_initial_layer1)
+                                                                    : memory_of_delay_of_phases(int(data[0]),Delay_variable,data[4],Phases_initial_layer1);
+    double* Phases_layer1_previous = shift_pi2_phases(int(data[0]), Phases_history_delay_layer1);//Phases changer
     // Hint3: When i change it that add variable to data.txt
-    ofstream Avg_Sync(name_file_data("Save/Avg_Sync/layer1/",data,12)+".txt");
-    double Coupling_variable = data[6];
+    const string Avg_Sync_name = name_file_data(job.output+"Save/Avg_Sync/layer1/",data,12)+".txt";
+    const string Sync_stats_name = name_file_data(job.output+"Save/Sync_stats/layer1/",data,12)+".txt";
+    const string Checkpoint_name = name_file_data(job.output+"Save/Checkpoint/layer1/",data,12)+".ckpt";
+    const double Checkpoint_every = Number_of_data > 14 ? data[14] * 60.0 : 0.0;// seconds
+    Coupling_steps steps(data, job.backward);
+    long coupling_index = 0;
+    double Coupling_variable = steps.coupling(0);
+    Coupling_grid grid(data, Number_of_data, job.backward);
+    grid.opposite = job.opposite;
+    Sweep_checkpoint start;// adaptive grid: the state the running coupling started from
+    Sweep_checkpoint checkpoint;
+    bool resumed = resume && read_checkpoint(Checkpoint_name, data, Number_of_data, checkpoint)
+                   && restore_history(Phases_history_delay_layer1, checkpoint);
+    if (resumed) {
+        Coupling_variable = checkpoint.coupling;
+        coupling_index = steps.index(checkpoint.coupling);
+        copy(checkpoint.phases.begin(), checkpoint.phases.end(), Phases_layer1_previous);
+        grid.position = checkpoint.grid_position;
+        grid.step = checkpoint.grid_step;
+        grid.attempt = checkpoint.grid_attempt;
+        grid.r_kept = checkpoint.grid_r;
+    }
+    ofstream Avg_Sync(Avg_Sync_name, resumed ? resume_output(Avg_Sync_name, checkpoint.avg_sync_bytes) : ios::out);
+    ofstream Sync_stats(Sync_stats_name, resumed ? resume_output(Sync_stats_name, checkpoint.stats_bytes) : ios::out);
+    if (!resumed) write_stats_header(Sync_stats);
+    Running_stats stats_layer1;// mean, std, CI, min, max of r over the averaged steps
+    double last_checkpoint = omp_get_wtime();
     cout<<"8. G to Coupling_variable. :)"<<endl;
-    while (Coupling_variable >= (data[8])) { // Coupling loop
+    while (grid.enabled() ? !grid.done() : coupling_index <= steps.last) { // Coupling loop
+        if (grid.enabled()) {// kept to go back to if this coupling jumps too far
+            Coupling_variable = grid.coupling();
+            start.phases.assign(Phases_layer1_previous, Phases_layer1_previous + int(data[0]));
+            save_history(Phases_history_delay_layer1, start);
+        }
         //time_t start_calculate_time = time(NULL);
         //filesystem::create_directories(name_file_data("Save/Phases/layer1/",data,12));
-        ofstream Save_phases_for_each_coupling("Save/Phases/layer1/k="+to_string(Coupling_variable)+".txt");
+        const string Phases_name = job.output+"Save/Phases/layer1/k="+to_string(Coupling_variable)+".txt";
         double Total_synchrony_layer1 = 0;
         int counter_of_total_sync =0;
-        double Time_variable = data[3];// reset time for new time
-        while (Time_variable < (data[5] + data[4])) {
-            Connected_Constant_Runge_Kutta_4(data,Delay_variable, Coupling_variable, frequency_layer1, adj_layer1, Phases_layer1_previous, Phases_history_delay_layer1,Phases_next_layer1);
-            double synchrony_layer1 = order_parameter(int(data[0]), Phases_layer1_previous);// order parameters
-            Save_phases_for_each_coupling << Time_variable << '\t';
+        long steps_used = 0;
+        bool settled = false;
+        double Time_start = data[3];
+        steady_layer1.reset();
+        stats_layer1.reset();
+        if (resumed) {// the coupling the checkpoint was taken in
+            Time_start = checkpoint.time;
+            Total_synchrony_layer1 = checkpoint.total_synchrony;
+            counter_of_total_sync = checkpoint.counter_of_total_sync;
+            steps_used = checkpoint.steps_used;
+            steady_layer1.r = checkpoint.r;
+            steady_layer1.next_check = checkpoint.next_check;
+            stats_layer1 = checkpoint.stats;
+        }
+        ofstream Save_phases_for_each_coupling(Phases_name, resumed ? resume_output(Phases_name, checkpoint.phases_bytes) : ios::out);
+        resumed = false;
+        // phases go to the file on a writer thread; the time loop only copies them into a ring slot
+        Async_output output_layer1(int(data[0]), [&](long, double Time, const double* phases) {
+            Save_phases_for_each_coupling << Time << '\t';
             for (int i = 0; i < int(data[0]); i++) {
-                Save_phases_for_each_coupling << Phases_layer1_previous[i] << '\t';
+                Save_phases_for_each_coupling << phases[i] << '\t';
             }
-            Save_phases_for_each_coupling << endl;
+            Save_phases_for_each_coupling << '\n';
+        });
+        // one parallel region for the whole time loop: the kernels share out the nodes, output is single
+        #pragma omp parallel num_threads(Number_of_threads)
+        {
+        double Time_variable = Time_start;// reset time for new time (every thread keeps the same clock)
+        while (Time_variable < (data[5] + data[4])) {
+            const bool order_used = Time_variable >= int(data[5] * 0.8) || steady_layer1.enabled();// r only on steps that use it
+            Connected_Constant_Runge_Kutta_4_factored(data, Coupling_variable, frequency_layer1, adj_layer1, Phases_layer1_previous, Phases_history_delay_layer1,Phases_next_layer1,trig_layer1,
+                                                      order_used ? &order_layer1 : nullptr);
+            double synchrony_layer1 = order_used ? order_parameter(int(data[0]), order_layer1) : 0.0;// order parameters, summed in the RK4 update
+            #pragma omp single
+            {
+            copy(Phases_layer1_previous, Phases_layer1_previous + int(data[0]), output_layer1.acquire());
+            output_layer1.publish(steps_used, Time_variable);
             if (Time_variable >= int(data[5] * 0.8)) {// add sync to total sync
                 Total_synchrony_layer1 += synchrony_layer1;
                 counter_of_total_sync+=1;
+                stats_layer1.add(synchrony_layer1);
             }
+            steps_used++;
+            settled = steady_layer1.add(synchrony_layer1);
+            if (!settled && Checkpoint_every > 0 && !grid.enabled() && omp_get_wtime() - last_checkpoint >= Checkpoint_every) {
+                output_layer1.drain();// the phase file holds every step up to here
+                Save_phases_for_each_coupling.flush();
+                Avg_Sync.flush();
+                Sync_stats.flush();
+                checkpoint.coupling = Coupling_variable;
+                checkpoint.time = Time_variable + data[4];// same sum as the loop below
+                checkpoint.steps_used = steps_used;
+                checkpoint.counter_of_total_sync = counter_of_total_sync;
+                checkpoint.total_synchrony = Total_synchrony_layer1;
+                checkpoint.avg_sync_bytes = uint64_t(Avg_Sync.tellp());
+                checkpoint.phases_bytes = uint64_t(Save_phases_for_each_coupling.tellp());
+                checkpoint.stats_bytes = uint64_t(Sync_stats.tellp());
+                checkpoint.stats = stats_layer1;
+                checkpoint.phases.assign(Phases_layer1_previous, Phases_layer1_previous + int(data[0]));
+                save_history(Phases_history_delay_layer1, checkpoint);
+                checkpoint.r = steady_layer1.r;
+                checkpoint.next_check = steady_layer1.next_check;
+                write_checkpoint(Checkpoint_name, data, Number_of_data, checkpoint);
+                last_checkpoint = omp_get_wtime();
+            }
+            }
+            if (settled) break;// every thread sees the flag after the single's barrier
             Time_variable += data[4];
         }
+        }
+        output_layer1.finish();// everything written before the file is closed
+        if (output_layer1.backpressure) cout << "k=" << Coupling_variable << "\toutput ring full on " << output_layer1.backpressure << " steps" << endl;
         Total_synchrony_layer1=Total_synchrony_layer1/counter_of_total_sync;// calculate total sync and pint it
+        if (settled) {// stopped early: mean of the settled segment, the statistics over the same samples
+            Total_synchrony_layer1 = steady_layer1.mean;
+            stats_layer1.reset();
+            for (size_t i = steady_layer1.r.size() / 5; i < steady_layer1.r.size(); i++) stats_layer1.add(steady_layer1.r[i]);
+        }
+        if (grid.enabled() && !grid.accept(Total_synchrony_layer1)) {// r jumped: back to the last coupling, half the step
+            Save_phases_for_each_coupling.close();
+            filesystem::remove(Phases_name, ignored);
+            copy(start.phases.begin(), start.phases.end(), Phases_layer1_previous);
+            restore_history(Phases_history_delay_layer1, start);
+            continue;
+        }
         //time_t end_calculate_time = time(NULL);// end of calculate time
         //cout<< Coupling_variable << '\t' << Total_synchrony_layer1 <<'\t' <<"Execution Time: "<< (double)(end_calculate_time-start_calculate_time)<<" Seconds"<<endl;
         //Avg_Sync << Coupling_variable << '\t' << Total_synchrony_layer1<< '\t' << (double)(end_calculate_time-start_calculate_time) << endl;
-        Avg_Sync << Coupling_variable << '\t' << Total_synchrony_layer1<< endl;
+        Avg_Sync << Coupling_variable << '\t' << Total_synchrony_layer1;
+        if (steady_layer1.enabled()) Avg_Sync << '\t' << steps_used;// time steps actually integrated
+        Avg_Sync << endl;
+        write_stats_row(Sync_stats, Coupling_variable, steps_used, stats_layer1);
         Save_phases_for_each_coupling.close();
-        Coupling_variable -= data[7];// next Coupling_variable
+        Coupling_variable = grid.enabled() ? grid.coupling() : steps.coupling(++coupling_index);// next Coupling_variable
+        if (Checkpoint_every > 0) {// between couplings: the next one starts from these phases
+            Avg_Sync.flush();
+            Sync_stats.flush();
+            checkpoint = Sweep_checkpoint();
+            checkpoint.coupling = Coupling_variable;
+            checkpoint.time = data[3];
+            checkpoint.next_check = Steady_state().next_check;
+            checkpoint.avg_sync_bytes = uint64_t(Avg_Sync.tellp());
+            checkpoint.stats_bytes = uint64_t(Sync_stats.tellp());
+            checkpoint.phases.assign(Phases_layer1_previous, Phases_layer1_previous + int(data[0]));
+            save_history(Phases_history_delay_layer1, checkpoint);
+            checkpoint.grid_position = grid.position;
+            checkpoint.grid_step = grid.step;
+            checkpoint.grid_attempt = grid.attempt;
+            checkpoint.grid_r = grid.r_kept;
+            write_checkpoint(Checkpoint_name, data, Number_of_data, checkpoint);
+            last_checkpoint = omp_get_wtime();
+        }
     }
-    write_last_phase("Save/Last_Phase/layer1/",data,12,Phases_layer1_previous);
+    write_last_phase(job.output+"Save/Last_Phase/layer1/",data,12,Phases_layer1_previous);
     Avg_Sync.close();
-    delete Phases_layer1_previous;
-    delete Phases_next_layer1;
-    delete Phases_history_delay_layer1[0];
+    Sync_stats.close();
+    delete[] Phases_layer1_previous;
+    delete[] Phases_next_layer1;
+    return 0;
+}
+
+// Ramp mode (data[17] > 0): the sweep as one integration with k(t) moving all the time, so the
+// transient is paid once at k_0 instead of once per coupling. No checkpoints in this mode.
+int run_ramp(const Sweep_job& job, const double* frequency_layer1, const double* Phases_initial_layer1,
+             const Sparse_adjacency& adj_layer1, bool Heterogeneous_delay) {
+    vector<double> rows = job.data;// the job's own data.txt
+    double* data = rows.data();
+    int Number_of_data = int(rows.size());
+    int Number_of_threads = number_of_threads(Number_of_data > 12 ? data[12] : 0);
+    error_code ignored;
+    for (string folder : {"Save/Avg_Sync/layer1", "Save/Phases/layer1", "Save/Last_Phase/layer1"}) {
+        filesystem::create_directories(job.output + folder, ignored);
+    }
+    double Delay_variable = data[9];
+    double* Phases_next_layer1 = new double[int(data[0])];
+    Trig_workspace trig_layer1 = Trig_workspace(int(data[0]), Heterogeneous_delay ? adj_layer1.Number_of_edge : 0);// sin/cos and neighbour sums, reused every step
+    Reduction_workspace order_layer1 = Reduction_workspace(int(data[0]));// block sums of the order parameter
+    Delay_history Phases_history_delay_layer1 = Heterogeneous_delay ? memory_of_delay_of_phases(adj_layer1, Phases_initial_layer1)
+                                                                    : memory_of_delay_of_phases(int(data[0]),Delay_variable,data[4],Phases_initial_layer1);
+    double* Phases_layer1_previous = shift_pi2_phases(int(data[0]), Phases_history_delay_layer1);//Phases changer
+    ofstream Avg_Sync(name_file_data(job.output+"Save/Avg_Sync/layer1/",data,12)+".txt");
+    ofstream Save_phases_for_each_coupling(job.output+"Save/Phases/layer1/ramp,k="+to_string(data[6])+","+to_string(data[8])+".txt");
+    Coupling_ramp ramp(data, Number_of_data, job.backward);
+    long steps_used = 0;
+    cout<<"8. G to Coupling ramp. :)"<<endl;
+    // columns: time, k(t), phases
+    Async_output output_layer1(int(data[0]) + 1, [&](long, double Time, const double* phases) {
+        Save_phases_for_each_coupling << Time << '\t';
+        for (int i = 0; i < int(data[0]) + 1; i++) {
+            Save_phases_for_each_coupling << phases[i] << '\t';
+        }
+        Save_phases_for_each_coupling << '\n';
+    });
+    #pragma omp parallel num_threads(Number_of_threads)
+    {
+    double Time_variable = data[3];// every thread keeps the same clock
+    while (!ramp.done()) {
+        Connected_Constant_Runge_Kutta_4_factored(data, ramp.coupling, frequency_layer1, adj_layer1, Phases_layer1_previous, Phases_history_delay_layer1,Phases_next_layer1,trig_layer1,
+                                                  &order_layer1);
+        double synchrony_layer1 = order_parameter(int(data[0]), order_layer1);
+        #pragma omp single
+        {
+        double* slot = output_layer1.acquire();
+        slot[0] = ramp.coupling;
+        copy(Phases_layer1_previous, Phases_layer1_previous + int(data[0]), slot + 1);
+        output_layer1.publish(steps_used, Time_variable);
+        steps_used++;
+        double k, r;
+        if (Time_variable >= int(data[5] * 0.8)) {// transient at k_0 as for every plateau, then the ramp
+            if (ramp.add(synchrony_layer1, k, r)) Avg_Sync << k << '\t' << r << endl;
+            ramp.advance(data[4]);
+        }
+        }
+        Time_variable += data[4];
+    }
+    }
+    output_layer1.finish();// everything written before the file is closed
+    cout << "8. G Coupling ramp done in " << steps_used << " steps. :)" << endl;
+    write_last_phase(job.output+"Save/Last_Phase/layer1/",data,12,Phases_layer1_previous);
+    Save_phases_for_each_coupling.close();
+    Avg_Sync.close();
+    delete[] Phases_layer1_previous;
+    delete[] Phases_next_layer1;
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && string(argv[1]) == "--simd-check") {// SIMD sin/cos: max ulp against libm and Gsin/s per path
+        simd_diagnostics();
+        return 0;
+    }
+    bool save_csr = false;// --save-csr: also write the adjacency as input_data/<name>.csr
+    bool resume = false;// --resume: carry on from the last checkpoint of this data.txt
+    string manifest;// --jobs <file>: every run of a job manifest in this process
+    bool hysteresis = false;// --hysteresis: every run as its forward and backward branch at once
+    for (int k = 1; k < argc; k++) {
+        if (string(argv[k]) == "--save-csr") save_csr = true;
+        if (string(argv[k]) == "--resume") resume = true;
+        if (string(argv[k]) == "--hysteresis") hysteresis = true;
+        if (string(argv[k]) == "--jobs" && k + 1 < argc) manifest = argv[++k];
+    }
+    // Hint1: count_rows_cols_file: para in address of file that is ./data.txt
+    // Hint2: read_data: first para is number of rows in data file and second para is boolean[0=dont show data,1=show data]
+    // data[0]=N & data[1]=L & data[2]=a
+    // data[3]=t_0 & data[4]=∆t & data[5]=t_f
+    // data[6]=k_0 & data[7]=∆k & data[8]=k_f
+    // data[9]=τ_0 & data[10]=∆τ & data[11]=τ_f
+    // data[12]=threads (optional, 0 or missing = all cores)
+    // data[13]=steady-state tolerance on Avg_Sync (optional, 0 or missing = full time horizon)
+    // data[14]=checkpoint every so many minutes (optional, 0 or missing = no checkpoints)
+    // data[15]=|∆r| that makes the adaptive coupling grid halve the step (optional, 0 or missing = uniform ∆k)
+    // data[16]=smallest ∆k of the adaptive grid (optional, 0 or missing = ∆k/64)
+    // data[17]=dk/dt of the coupling ramp (optional, 0 or missing = one plateau per coupling)
+    // data[18]=largest dr/dt of the ramp, slows it where r moves (optional, 0 or missing = fixed dk/dt)
+    int Number_of_data = count_rows_cols_file("data.txt");
+    double* data=read_data(Number_of_data,0);
+    Sweep_job job;// this folder's run
+    job.data.assign(data, data + Number_of_data);
+    job.backward = true;// backward sweep: k_0 down to k_f
+    job.frequency = "W=Natural frequency/w_mean2(0,4)";
+    job.phases = "P=Initial Phases/theta";//Initial Phases  P
+    job.adjacency = "A=Intralayer adjacency matrix/matrix_old";//adjacency matrix  A (CSR, .csr/.edges/.txt)
+    job.delays = "D=Delays/tau";//optional tau_j or tau_ij, replaces data[9]
+    int parallel = number_of_threads(Number_of_data > 12 ? data[12] : 0);// runs at once (manifest)
+    vector<Sweep_job> jobs = manifest.empty() ? vector<Sweep_job>{job} : read_job_manifest(manifest, job, parallel);
+    vector<Sweep_job> loops;// --hysteresis: the runs, before they are split in branches
+    if (hysteresis) {
+        parallel = max(parallel, 2);// the two branches of a loop always run side by side
+        loops.swap(jobs);
+        for (const Sweep_job& j : loops) {// the two branches of a loop next to each other
+            pair<Sweep_job, Sweep_job> branch = hysteresis_branches(j);
+            // the last finished loop of this run, if any: the adaptive grid also refines on the gap
+            const string last_loop = name_file_data(j.output+"Save/Hysteresis/layer1/",j.data.data(),12)+".txt";
+            branch.first.opposite = read_hysteresis_branch(last_loop, false);
+            branch.second.opposite = read_hysteresis_branch(last_loop, true);
+            jobs.push_back(branch.first);
+            jobs.push_back(branch.second);
+        }
+    }
+    // every distinct input read once
+    map<string, vector<double>> vectors;// W and P files
+    map<string, Sparse_adjacency> graphs;// by adjacency and delays
+    map<string, bool> Heterogeneous_delay;
+    for (const Sweep_job& j : jobs) {
+        for (const string& name : {j.frequency, j.phases}) {
+            if (vectors.count(name)) continue;
+            double* values = read_initial_1D(name, int(data[0]));
+            vectors[name].assign(values, values + int(data[0]));
+            delete[] values;
+        }
+        if (graphs.count(j.graph_key())) continue;
+        graphs[j.graph_key()] = read_initial_CSR(j.adjacency, int(data[0]), save_csr);
+        Heterogeneous_delay[j.graph_key()] = read_delay_CSR(j.delays, graphs[j.graph_key()], j.data[4]);
+    }
+    run_in_pool(int(jobs.size()), parallel, [&](int k) {
+        const Sweep_job& j = jobs[k];
+        if (Coupling_ramp(j.data.data(), int(j.data.size()), j.backward).enabled()) {
+            run_ramp(j, vectors.at(j.frequency).data(), vectors.at(j.phases).data(), graphs.at(j.graph_key()),
+                     Heterogeneous_delay.at(j.graph_key()));
+            return;
+        }
+        run_sweep(j, vectors.at(j.frequency).data(), vectors.at(j.phases).data(), graphs.at(j.graph_key()),
+                  Heterogeneous_delay.at(j.graph_key()), resume);
+    });
+    for (size_t k = 0; k < loops.size(); k++) {// loop area and width from the two Avg_Sync files
+        const Sweep_job& up = jobs[2 * k];
+        const Sweep_job& down = jobs[2 * k + 1];
+        const double k_low = up.data[6], k_step = Coupling_grid(up.data.data(), int(up.data.size()), false).unit;// finest grid
+        Hysteresis_loop loop = hysteresis_loop(
+            read_sync_branch(name_file_data(up.output+"Save/Avg_Sync/layer1/",up.data.data(),12)+".txt", k_low, k_step),
+            read_sync_branch(name_file_data(down.output+"Save/Avg_Sync/layer1/",down.data.data(),12)+".txt", k_low, k_step),
+            k_low, k_step);
+        write_hysteresis(name_file_data(loops[k].output+"Save/Hysteresis/layer1/",loops[k].data.data(),12)+".txt", loop);
+        cout << "9. W Hysteresis loop: area " << loop.area << ", width " << loop.width << ". :)" << endl;
+    }
+    delete[] data;
     return 0;
 }